@@ -30,6 +30,16 @@ TOOLCHAIN_PATH=${VEGA_TOOLCHAIN_PATH}
 RISCV_LIB_FLAGS= -march=$(RISCV_ARCH) -mabi=$(RISCV_ABI) -mcmodel=$(RISCV_CMODEL)
 endif
 
+# Selects the interrupt lines of the SoC in interrupt.h
+RISCV_LIB_FLAGS += -DVEGA_MACHINE_$(MACHINE)
+
+# Interrupt statistics, see irq_stats.h: make VEGA_IRQ_STATS=1 after a
+# make clean, so that the library is built again.
+ifeq ($(VEGA_IRQ_STATS),1)
+RISCV_LIB_FLAGS += -DVEGA_IRQ_STATS
+RISCV_CFLAGS    += -DVEGA_IRQ_STATS
+endif
+
 #+++++++++++++++++++++++
 # Toolchain
 #+++++++++++++++++++++++
@@ -68,6 +78,9 @@ RISCV_ASFLAGS   += -march=$(RISCV_ARCH) -mabi=$(RISCV_ABI) -mcmodel=$(RISCV_CMOD
 # Prune unused functions and data
 RISCV_CFLAGS   += -fno-builtin-printf -fdata-sections -ffunction-sections -fno-builtin-memcmp 
 RISCV_CXXFLAGS += -fno-builtin-printf -fdata-sections -ffunction-sections -fno-builtin-memcmp 
+# Same SoC selection as the library
+RISCV_CFLAGS    += -DVEGA_MACHINE_$(MACHINE)
+RISCV_CXXFLAGS  += -DVEGA_MACHINE_$(MACHINE)
 # Include baremetal driver headers
 RISCV_CCASFLAGS += -I$(SDK_PATH)/bsp/include
 RISCV_CFLAGS    += -I$(SDK_PATH)/bsp/include
@@ -20,13 +20,11 @@
 
 #include <include/debug_uart.h>
 #include <include/encoding.h>
+#include <include/delay.h>
+#include <include/timebase.h>
 
 #define HAS_FLOAT 1
 
-#define NUM_COUNTERS 2
-static uintptr_t counters[NUM_COUNTERS];
-static char* counter_names[NUM_COUNTERS];
-
 void* memset(void* dest, int byte, size_t len);
 void* memcpy(void* dest, const void* src, size_t len);
 size_t strnlen(const char *s, size_t n);
@@ -241,33 +239,34 @@ static int skip_atoi(const char **s)
 }
 
 
+/** @fn udelay
+ * @brief Wait for count microseconds.
+ * @details Counted in mcycle, see delay_us.
+ */
 int udelay(unsigned int count)
 {
-	for(int i=0;i<(count*35);i++); //delay millisecond calculation with board mhz
+	delay_us(count);
+	return 0;
 }
-/*
-int udelay(unsigned int count)
-{
-	clock_t clock_count,target_count;	
-
-	clock_count = rdcycle(); //delay millisecond calculation with board mhz
-
-	target_count = clock_count + (count*35);
-
-	while(clock_count < target_count) 
-	{
-		clock_count = rdcycle();
-	}
 
-}*/
+/** @fn delay
+ * @brief Wait for count milliseconds.
+ * @details Counted in mcycle, see delay_ms.
+ */
+int delay(unsigned int count)
+{
+	delay_ms(count);
+	return 0;
+}
 
+/** @fn get_time
+ * @brief Core cycles since reset.
+ * @details clock_t is 32 bit on 32 bit processors and wraps, use time_now_cycles
+ *	    for the full 64 bit count.
+ */
 clock_t get_time()
 {
-	clock_t clock_count;	
-
-	clock_count = read_csr(mcycle); 
-	
-	return clock_count;
+	return (clock_t)time_now_cycles();
 }
 
 
@@ -0,0 +1,95 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  bitbang.c
+ * Brief Description of file             :  Cycle accurate bit-bang engine.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+#include <include/stdlib.h>
+#include <include/gpio.h>
+#include <include/bitbang.h>
+#include <include/config.h>
+#include <include/timebase.h>
+
+
+/** @fn bitbang_run
+  @brief  Play an edge schedule on an output pin.
+  @details The pin must already be OUTPUT. Each edge is written with one store to the
+	   masked data address at start + edge[i].at.
+  @warning Edges must be sorted and far enough apart for the loop, about 10 cycles.
+  @param[in] unsigned short pin_no, edge schedule, unsigned int count: number of edges.
+  @param[Out] No output parameter.
+*/
+void bitbang_run(US pin_no, const BITBANG_EDGE_type *edge, UI count) {
+
+	volatile US *reg = (volatile US *)(GPIO_PORT_BASE(pin_no >> 4) + ((UL)GPIO_PIN_MASK(pin_no) << 2));
+	US high = GPIO_PIN_MASK(pin_no);
+	UL mie, start;
+
+	mie = bitbang_frame_begin();
+	start = time_now_cycles32() + BITBANG_LEAD_CYCLES;
+	for(UI i = 0; i < count; i++)
+	{
+		US value = edge[i].level ? high : 0;
+
+		bitbang_wait_until(start + edge[i].at);
+		*reg = value;
+	}
+	bitbang_frame_end(mie);
+}
+
+
+/** @fn bitbang_symbols
+  @brief  Send bits as pulse width coded symbols.
+  @details Every bit starts with a rising edge one period after the previous one and falls
+	   after t0h or t1h. The next bit is fetched while the pin is high, so only the
+	   edge stores sit on the deadlines. Bits are sent MSB first, the pin ends low.
+  @warning The pin must be OUTPUT and low. Interrupts are masked for bits * period.
+  @param[in] unsigned short pin_no, unsigned char *data, unsigned int bits, symbol timing.
+  @param[Out] No output parameter.
+*/
+void bitbang_symbols(US pin_no, const UC *data, UI bits, const BITBANG_SYMBOL_type *symbol) {
+
+	volatile US *reg = (volatile US *)(GPIO_PORT_BASE(pin_no >> 4) + ((UL)GPIO_PIN_MASK(pin_no) << 2));
+	US high = GPIO_PIN_MASK(pin_no);
+	UI t0h = symbol->t0h, t1h = symbol->t1h, period = symbol->period;
+	UL mie, rise, fall;
+	UI bit;
+
+	if(bits == 0)
+		return;
+
+	bit = data[0] & 0x80;
+	mie = bitbang_frame_begin();
+	rise = time_now_cycles32() + BITBANG_LEAD_CYCLES;
+	for(UI i = 1; ; i++)
+	{
+		bitbang_wait_until(rise);
+		*reg = high;
+		fall = rise + (bit ? t1h : t0h);
+		rise += period;
+		if(i < bits)
+			bit = data[i >> 3] & (0x80 >> (i & 7));
+		bitbang_wait_until(fall);
+		*reg = 0;
+		if(i >= bits)
+			break;
+	}
+	bitbang_frame_end(mie);
+}
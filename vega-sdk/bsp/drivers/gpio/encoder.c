@@ -0,0 +1,259 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  encoder.c
+ * Brief Description of file             :  Table driven quadrature encoder decoder.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+#include <include/stdlib.h>
+#include <include/gpio.h>
+#include <include/encoder.h>
+#include <include/timer.h>
+#include <include/interrupt.h>
+#include <include/config.h>
+
+
+#define ENCODER_INVALID		2	// Both channels changed, a step was missed.
+
+// Count change indexed by (previous AB << 2) | current AB.
+static const signed char encoder_table[16] = {
+	 0, -1,  1,  ENCODER_INVALID,
+	 1,  0,  ENCODER_INVALID, -1,
+	-1,  ENCODER_INVALID,  0,  1,
+	 ENCODER_INVALID,  1, -1,  0
+};
+
+typedef struct
+{
+	UC a_bit;			// Bit of channel A in the 32 pin sample.
+	UC b_bit;
+	UC ab;				// Previous A/B levels.
+	volatile int count;
+	int window_start;		// Count at the start of the velocity window.
+	volatile int velocity;		// Counts in the last window.
+	volatile UI errors;
+}ENCODER_type;
+
+static struct
+{
+	ENCODER_type enc[ENCODER_MAX];
+	UC encoders;
+	US mask[2];			// Channel pins, per port.
+	US window_ticks;
+	US window_tick;
+	UC timer_no;
+}qe;
+
+
+/** @fn encoder_sample
+  @brief  Read the channels of every encoder.
+  @details One load per port, GPIO 1 in the upper half.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] Pin levels.
+*/
+static inline UI encoder_sample(void) {
+
+	return GPIO_read_port(GPIO_0, qe.mask[0]) | ((UI)GPIO_read_port(GPIO_1, qe.mask[1]) << 16);
+}
+
+
+/** @fn encoder_timer_isr
+  @brief  Encoder tick.
+  @details Decodes the A/B transition of every encoder and closes the velocity window.
+  @warning
+  @param[in] void *ctx: not used.
+  @param[Out] No output parameter.
+*/
+static void encoder_timer_isr(void *ctx) {
+
+	UI sample;
+
+	sample = encoder_sample();
+
+	for(UC i = 0; i < qe.encoders; i++)
+	{
+		ENCODER_type *e = &qe.enc[i];
+		UC ab = (((sample >> e->a_bit) & 1) << 1) | ((sample >> e->b_bit) & 1);
+		signed char step = encoder_table[(e->ab << 2) | ab];
+
+		e->ab = ab;
+		if(step == ENCODER_INVALID)
+			e->errors++;
+		else
+			e->count += step;
+	}
+
+	if(++qe.window_tick < qe.window_ticks)
+		return;
+	qe.window_tick = 0;
+	for(UC i = 0; i < qe.encoders; i++)
+	{
+		ENCODER_type *e = &qe.enc[i];
+
+		e->velocity = e->count - e->window_start;
+		e->window_start = e->count;
+	}
+}
+
+
+/** @fn encoder_init
+  @brief  Initialise the encoder decoder.
+  @details Removes all encoders.
+  @warning
+  @param[in] unsigned short window_ticks: ticks over which the velocity is measured.
+  @param[Out] No output parameter.
+*/
+void encoder_init(US window_ticks) {
+
+	qe.encoders = 0;
+	qe.mask[0] = qe.mask[1] = 0;
+	qe.window_ticks = window_ticks ? window_ticks : 1;
+	qe.window_tick = 0;
+}
+
+
+/** @fn encoder_add
+  @brief  Add an encoder.
+  @details The channel pins are configured as INPUT. Call before encoder_start.
+  @warning
+  @param[in] unsigned short pin_a, unsigned short pin_b
+  @param[Out] Encoder index, or -1 if all encoders are used or a pin is not on GPIO 0 or 1.
+*/
+int encoder_add(US pin_a, US pin_b) {
+
+	ENCODER_type *e;
+
+	if(qe.encoders >= ENCODER_MAX)
+		return -1;
+	if(pin_a > PIN_31 || pin_b > PIN_31)
+		return -1;
+
+	e = &qe.enc[qe.encoders];
+	e->a_bit = pin_a;
+	e->b_bit = pin_b;
+	e->count = 0;
+	e->window_start = 0;
+	e->velocity = 0;
+	e->errors = 0;
+
+	qe.mask[pin_a >> 4] |= GPIO_PIN_MASK(pin_a);
+	qe.mask[pin_b >> 4] |= GPIO_PIN_MASK(pin_b);
+	GPIO_set_dir(pin_a >> 4, GPIO_PIN_MASK(pin_a), GPIO_DIR_IN);
+	GPIO_set_dir(pin_b >> 4, GPIO_PIN_MASK(pin_b), GPIO_DIR_IN);
+	return qe.encoders++;
+}
+
+
+/** @fn encoder_start
+  @brief  Start decoding.
+  @details Runs the decoder from the interrupt of timer_no. initialize_interrupt_table()
+	   must have been called before.
+  @warning Channel edges must be at least one tick apart, the tick must be shorter than
+	   a quarter of the fastest encoder period.
+  @param[in] unsigned char timer_no, unsigned int tick_clocks
+  @param[Out] No output parameter.
+*/
+void encoder_start(UC timer_no, UI tick_clocks) {
+
+	UI sample = encoder_sample();
+
+	for(UC i = 0; i < qe.encoders; i++)
+	{
+		ENCODER_type *e = &qe.enc[i];
+
+		e->ab = (((sample >> e->a_bit) & 1) << 1) | ((sample >> e->b_bit) & 1);
+	}
+	qe.timer_no = timer_no;
+
+	timer_set_callback(timer_no, encoder_timer_isr, 0);
+	timer_run_in_intr_mode(timer_no, tick_clocks);
+	interrupt_enable(TIMER_IRQ(timer_no));
+}
+
+
+/** @fn encoder_stop
+  @brief  Stop decoding.
+  @details
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+void encoder_stop(void) {
+
+	Timer(qe.timer_no).Control = 0x0;	// Disable timer.
+	__asm__ __volatile__ ("fence");
+}
+
+
+/** @fn encoder_count
+  @brief  Accumulated count of an encoder.
+  @details Four counts per encoder cycle.
+  @warning
+  @param[in] unsigned char encoder
+  @param[Out] Count.
+*/
+int encoder_count(UC encoder) {
+
+	return qe.enc[encoder].count;
+}
+
+
+/** @fn encoder_velocity
+  @brief  Velocity of an encoder.
+  @details Counts in the last complete velocity window.
+  @warning
+  @param[in] unsigned char encoder
+  @param[Out] Counts per window_ticks.
+*/
+int encoder_velocity(UC encoder) {
+
+	return qe.enc[encoder].velocity;
+}
+
+
+/** @fn encoder_errors
+  @brief  Number of invalid transitions of an encoder.
+  @details Both channels changed between two samples, the tick is too slow.
+  @warning
+  @param[in] unsigned char encoder
+  @param[Out] Invalid transitions.
+*/
+UI encoder_errors(UC encoder) {
+
+	return qe.enc[encoder].errors;
+}
+
+
+/** @fn encoder_reset
+  @brief  Clear the count of an encoder.
+  @details The velocity is not affected.
+  @warning
+  @param[in] unsigned char encoder
+  @param[Out] No output parameter.
+*/
+void encoder_reset(UC encoder) {
+
+	ENCODER_type *e = &qe.enc[encoder];
+
+	interrupt_disable(TIMER_IRQ(qe.timer_no));
+	e->window_start -= e->count;
+	e->count = 0;
+	interrupt_enable(TIMER_IRQ(qe.timer_no));
+}
@@ -26,61 +26,60 @@
 #include <include/stdlib.h>
 #include <include/gpio.h>
 #include <include/config.h>
+#include <include/timer.h>
+#include <include/interrupt.h>
+#include <include/timebase.h>
+
+
+static US gpio_dir_shadow[2];		// RAM copy of the GPIO 0 and GPIO 1 direction registers.
+static UC gpio_dir_loaded;		// Bit n set once the shadow of GPIO n is loaded.
+
+
+/** @fn gpio_dir_update
+  @brief  Update the direction of pins through the shadow.
+  @details The direction register is written only if the direction of a pin in mask
+	   actually changes. The shadow is loaded from the register on first use.
+  @warning 
+  @param[in] unsigned char port, unsigned short mask, unsigned short dir
+  @param[Out] No output parameter.
+*/
+static void gpio_dir_update(UC port, US mask, US dir) {
+
+	volatile US *gpio_dir_addr = (volatile US *)(GPIO_PORT_BASE(port) + GPIO_DIR_OFFSET); // Direction register.
+	US dir_data = 0;
+
+	if(!(gpio_dir_loaded & (1 << port)))
+	{
+		gpio_dir_shadow[port] = *gpio_dir_addr;	// First access, load the shadow.
+		gpio_dir_loaded |= (1 << port);
+	}
+
+	dir_data = (gpio_dir_shadow[port] & ~mask) | (dir & mask);
+	if(dir_data == gpio_dir_shadow[port])
+		return;					// No pin changes direction.
+
+	gpio_dir_shadow[port] = dir_data;
+	*gpio_dir_addr = dir_data;			// Data written to direction register.
+	__asm__ __volatile__ ("fence");
+}
 
 
 /** @fn GPIO_read_pin
   @brief  Read GPIO pin value.
-  @details Read the GPIO pin value by setting the direction as INPUT in GPIO direction register.
+  @details Configure the pin as INPUT (only if it is not already) and read the pin value.
   @warning 
   @param[in] unsigned short pin_no
   @param[Out] Pin value as 16 bit data.
 */
 US GPIO_read_pin(US pin_no) {
 
-	UC gpio_number = 0;
-	US dir_data = 0;
-	US bit_position = 0;
-	volatile US *gpio_0_dir_addr = (volatile US *)(GPIO_0_BASE_ADDRESS +0x40000) ; // GPIO 0 direction register.
-	volatile US *gpio_1_dir_addr = (volatile US *)(GPIO_1_BASE_ADDRESS +0x40000) ; // GPIO 1 direction register.
-
-	UL gen_gpio_0_addr,gen_gpio_1_addr;
-	volatile US *gpio_0_data, *gpio_1_data;
+	UC gpio_number = (pin_no <= 15) ? GPIO_0 : GPIO_1;	// Pins 0 to 15 in GPIO 0, 16 to 31 in GPIO 1.
+	US bit_position = (1 << (pin_no & 15));			// Align the selected pin to its position.
 	US read_data = 0;
 
-	if(pin_no <= 15)
-		gpio_number = 0; 			// Pins 0 to 15 defined in GPIO 0.
-	else	
-		gpio_number = 1;			// Pins 16 to 31 defined in GPIO 1.
-
-
-	if(gpio_number == 0)
-	{
-		bit_position = (1 << pin_no);		// Align the selected pin to its position.
-		dir_data =  *gpio_0_dir_addr; 		// Address of the direction register.
-		dir_data &= ~(bit_position);		// Clearing a bit configures the pin to be INPUT.
-		*gpio_0_dir_addr = dir_data;		// Data written to direction register.
-		__asm__ __volatile__ ("fence");
+	gpio_dir_update(gpio_number, bit_position, GPIO_DIR_IN);	// Clearing a bit configures the pin to be INPUT.
 
-		gen_gpio_0_addr = GPIO_0_BASE_ADDRESS;	// Base address of GPIO 0.
-		gen_gpio_0_addr+=(bit_position << 2);	// Generate address of the selected GPIO pin in GPIO 0.
-		gpio_0_data = (US *)gen_gpio_0_addr;	// Generated address.
-		read_data = *gpio_0_data; 		// Read data from the address.
-		
-	}
-	else if(gpio_number == 1)
-	{
-		pin_no = (pin_no - 16);
-		bit_position = (1 << pin_no);		// Align the selected pin to its position.
-		dir_data =  *gpio_1_dir_addr;		// Address of the direction register.
-		dir_data &= ~(bit_position);		// Clearing a bit configures the pin to be INPUT.
-		*gpio_1_dir_addr = dir_data;		// Data written to direction register.
-		__asm__ __volatile__ ("fence");
-
-		gen_gpio_1_addr = GPIO_1_BASE_ADDRESS;	// Base address of GPIO 1.
-		gen_gpio_1_addr+=(bit_position << 2);	// Generate address of the selected GPIO pin in GPIO 1.
-		gpio_1_data = (US *)gen_gpio_1_addr;	// Generated address.
-		read_data = *gpio_1_data;		// Read data from the address.
-	}
+	read_data = GPIO_read_port(gpio_number, bit_position);	// Read data from the masked address.
 	__asm__ __volatile__ ("fence");
 
 	if(read_data)
@@ -91,71 +90,252 @@ US GPIO_read_pin(US pin_no) {
 
 /** @fn GPIO_write_pin
  * @brief  Write GPIO pin value.
- * @details Write the GPIO pin value by setting the direction as OUTPUT.
+ * @details Configure the pin as OUTPUT (only if it is not already) and write the pin value.
  * @warning 
  * @param[in] unsigned short, unsigned short
  * @param[Out] No output parameter.
 */
 void GPIO_write_pin(US pin_no,US data) {
-	
-	UC gpio_number = 0;
-	US dir_data = 0;
-	US bit_position = 0;
-	volatile US *gpio_0_dir_addr = (volatile US *)(GPIO_0_BASE_ADDRESS +0x40000) ; // GPIO 0 direction register.
-	volatile US *gpio_1_dir_addr = (volatile US *)(GPIO_1_BASE_ADDRESS +0x40000) ; // GPIO 1 direction register.
-	UL gen_gpio_0_addr,gen_gpio_1_addr;
-	volatile US *gpio_0_data, *gpio_1_data;
-
-	if(pin_no <= 15)
-		gpio_number = 0;			// Pins 0 to 15 defined in GPIO 0.
-	else	
-		gpio_number = 1;			// Pins 16 to 31 defined in GPIO 1.	
-
-	if(gpio_number == 0)
-	{
-		bit_position = (1 << pin_no);			// Align the selected pin to its position.
-		dir_data =  *gpio_0_dir_addr;	 		// Address of the direction register.
-		dir_data |= bit_position;			//Setting a bit configures the pin to be OUTPUT.
-		*gpio_0_dir_addr = dir_data;			// Data written to direction register.
-		__asm__ __volatile__ ("fence");
 
-		gen_gpio_0_addr = GPIO_0_BASE_ADDRESS;		// Base address of GPIO 0.
-		gen_gpio_0_addr|=(bit_position << 2);		// Generate address of the selected GPIO pin in GPIO 0.
-		gpio_0_data = (US *)gen_gpio_0_addr;		// Generated address.
-		*gpio_0_data = (data << pin_no);		// Write data to the address.
-	}
-	else if(gpio_number == 1)
-	{
-		pin_no = (pin_no - 16);
-		bit_position = (1 << pin_no);			// Align the selected pin to its position.
-		dir_data =  *gpio_1_dir_addr;			// Address of the direction register.
-		dir_data |= bit_position;			//Setting a bit configures the pin to be OUTPUT.
-		*gpio_1_dir_addr = dir_data;			// Data written to direction register.
-		__asm__ __volatile__ ("fence");
+	UC gpio_number = (pin_no <= 15) ? GPIO_0 : GPIO_1;	// Pins 0 to 15 in GPIO 0, 16 to 31 in GPIO 1.
+	US bit_position = (1 << (pin_no & 15));			// Align the selected pin to its position.
 
-		gen_gpio_1_addr = GPIO_1_BASE_ADDRESS;		// Base address of GPIO 1.
-		gen_gpio_1_addr|=(bit_position << 2);		// Generate address of the selected GPIO pin in GPIO 0.
-		gpio_1_data = (US *)gen_gpio_1_addr;		// Generated address.
-		*gpio_1_data = (data << pin_no);		// Write data to the address.
-	}
-	__asm__ __volatile__ ("fence");
+	gpio_dir_update(gpio_number, bit_position, GPIO_DIR_OUT);	// Setting a bit configures the pin to be OUTPUT.
 
+	GPIO_write_port(gpio_number, bit_position, data ? bit_position : 0);	// Write data to the masked address.
 	return;   
 }
 
+/** @fn GPIO_config_pin
+ * @brief  Configure the direction of a GPIO pin once.
+ * @details Use with GPIO_put_pin/GPIO_get_pin, which do not touch the direction register.
+ *	    The direction register is written only if the direction changes.
+ * @warning Pins above PIN_31 are ignored.
+ * @param[in] unsigned short pin_no, unsigned short dir: GPIO_DIR_IN or GPIO_DIR_OUT.
+ * @param[Out] No output parameter.
+*/
+void GPIO_config_pin(US pin_no, US dir) {
+
+	if(pin_no > PIN_31)
+		return;
+	gpio_dir_update((pin_no <= 15) ? GPIO_0 : GPIO_1, (1 << (pin_no & 15)), dir);
+}
+
+/** @fn GPIO_write_port
+ * @brief  Write several pins of a GPIO port at once.
+ * @details The controller only updates the pins selected by the address bits [17:2],
+ *	    so all pins in mask are written with a single store. The direction
+ *	    register is not touched, use GPIO_set_dir to make the pins OUTPUT first.
+ * @warning 
+ * @param[in] unsigned char port: GPIO_0 or GPIO_1, unsigned short mask: pins to update,
+ *	      unsigned short value: new pin levels (bits outside mask are ignored).
+ * @param[Out] No output parameter.
+*/
+void GPIO_write_port(UC port, US mask, US value) {
+
+	volatile US *gpio_data = (volatile US *)(GPIO_PORT_BASE(port) + ((UL)mask << 2)); // Masked data address.
+
+	*gpio_data = value;				// Only the pins in mask change.
+	__asm__ __volatile__ ("fence");
+}
+
+/** @fn GPIO_read_port
+ * @brief  Read several pins of a GPIO port at once.
+ * @details The pins selected by mask are read with a single load. The direction
+ *	    register is not touched, use GPIO_set_dir to make the pins INPUT first.
+ * @warning 
+ * @param[in] unsigned char port: GPIO_0 or GPIO_1, unsigned short mask: pins to read.
+ * @param[Out] Pin levels, bits outside mask read as 0.
+*/
+US GPIO_read_port(UC port, US mask) {
+
+	volatile US *gpio_data = (volatile US *)(GPIO_PORT_BASE(port) + ((UL)mask << 2)); // Masked data address.
 
+	return *gpio_data;
+}
+
+/** @fn GPIO_set_dir
+ * @brief  Set the direction of several pins of a GPIO port.
+ * @details A set bit in dir configures the pin as OUTPUT, a cleared bit as INPUT.
+ *	    The direction register is written only if a pin in mask changes direction.
+ * @warning Ports other than GPIO_0 and GPIO_1 are ignored.
+ * @param[in] unsigned char port: GPIO_0 or GPIO_1, unsigned short mask: pins to configure,
+ *	      unsigned short dir: GPIO_DIR_IN, GPIO_DIR_OUT or a per pin pattern.
+ * @param[Out] No output parameter.
+*/
+void GPIO_set_dir(UC port, US mask, US dir) {
+
+	if(port > GPIO_1)
+		return;
+	gpio_dir_update(port, mask, dir);
+}
+
+
+/*  Pulse measurement
+*
+*   Edges are time stamped on the 64 bit time base and converted to
+*   microseconds with its fixed point factors, so measurements stay valid
+*   when the low word of the cycle counter wraps.
+***************************************************/
+
+#define PULSE_WAIT_START	0
+#define PULSE_WAIT_END		1
+#define PULSE_DONE		2
+
+typedef struct
+{
+	volatile US *data_addr;		// Masked data address of the pin.
+	US level;			// Pin value (masked) while in the pulse.
+	UC timer_no;
+	volatile UC state;
+	volatile UC status;
+	ULL deadline;			// Time at which the capture gives up.
+	ULL edge;			// Time of the leading edge.
+	volatile ULL width;		// Pulse width in cycles.
+}PULSE_CAPTURE_type;
+
+static PULSE_CAPTURE_type pulse_capture;
+
+
+/** @fn GPIO_pulse_measure
+  @brief  Measure a pulse with a deadline.
+  @details Waits for the pin to reach level, then for it to leave level, and returns the
+	   time in between. Both waits together are bounded by timeout_us. The pin is
+	   sampled with a single load from its masked data address per iteration.
+  @warning 
+  @param[in] unsigned short pin_no, unsigned short level: HIGH or LOW,
+	     unsigned long timeout_us, unsigned long *width_us: pulse width on success.
+  @param[Out] GPIO_PULSE_OK, GPIO_PULSE_NO_EDGE or GPIO_PULSE_TOO_LONG.
+*/
+UC GPIO_pulse_measure(US pin_no, US level, UL timeout_us, UL *width_us) {
+
+	volatile US *data_addr = GPIO_PIN_REG(pin_no);
+	US want = level ? GPIO_PIN_MASK(pin_no) : 0;
+	ULL deadline, edge, now;
+
+	GPIO_config_pin(pin_no, GPIO_DIR_IN);		// Direction register written only if needed.
+
+	deadline = time_now_cycles() + time_us_to_cycles(timeout_us);
+	do {
+		now = time_now_cycles();
+		if(now > deadline)
+			return GPIO_PULSE_NO_EDGE;
+	} while(*data_addr != want);			// Wait for the leading edge.
+
+	edge = now;
+	do {
+		now = time_now_cycles();
+		if(now > deadline)
+			return GPIO_PULSE_TOO_LONG;
+	} while(*data_addr == want);			// Wait for the trailing edge.
+
+	*width_us = (UL)time_cycles_to_us(now - edge);
+	return GPIO_PULSE_OK;
+}
+
+
+/** @fn pulse_duration
+  @brief  Measure a pulse.
+  @details Width in microseconds of the next pulse at level val on pin_number.
+  @warning Returns 0 if no complete pulse is seen within GPIO_PULSE_TIMEOUT_US.
+  @param[in] unsigned short pin_number, unsigned short val
+  @param[Out] Pulse width in microseconds.
+*/
 UL pulse_duration(US pin_number, US val)
 {
-	clock_t start_time=0, end_time=0;
 	UL total_time=0;
-	while(GPIO_read_pin(pin_number)!=val);
-	start_time =  get_time();
-	while(GPIO_read_pin(pin_number)==val);
-	end_time =  get_time();	
 
-	total_time = (end_time - start_time)*0.025;
+	if(GPIO_pulse_measure(pin_number, val, GPIO_PULSE_TIMEOUT_US, &total_time) != GPIO_PULSE_OK)
+		return 0;
 	return total_time;
 }
 
 
+/** @fn gpio_pulse_timer_isr
+  @brief  Sample the pin of the interrupt driven pulse capture.
+  @details Called at every tick of the capture timer. The edges are time stamped on the
+	   time base, so the resolution is one sample period.
+  @warning 
+  @param[in] void *ctx: not used.
+  @param[Out] No output parameter.
+*/
+static void gpio_pulse_timer_isr(void *ctx) {
+
+	PULSE_CAPTURE_type *cap = &pulse_capture;
+	ULL now;
+	US pin;
+
+	if(cap->state == PULSE_DONE)
+		return;
+	pin = *cap->data_addr;
+	now = time_now_cycles();
+
+	if(cap->state == PULSE_WAIT_START && pin == cap->level)
+	{
+		cap->edge = now;
+		cap->state = PULSE_WAIT_END;
+	}
+	else if(cap->state == PULSE_WAIT_END && pin != cap->level)
+	{
+		cap->width = now - cap->edge;
+		cap->status = GPIO_PULSE_OK;
+		cap->state = PULSE_DONE;
+	}
+	else if(now > cap->deadline)
+	{
+		cap->status = (cap->state == PULSE_WAIT_START) ? GPIO_PULSE_NO_EDGE : GPIO_PULSE_TOO_LONG;
+		cap->state = PULSE_DONE;
+	}
+
+	if(cap->state == PULSE_DONE)
+	{
+		Timer(cap->timer_no).Control = 0x0;	// Disable timer, capture finished.
+		__asm__ __volatile__ ("fence");
+	}
+}
+
+
+/** @fn GPIO_pulse_capture_start
+  @brief  Start an interrupt driven pulse measurement.
+  @details The pin is sampled from the interrupt of timer_no every sample_clocks timer
+	   clocks and the CPU is free until GPIO_pulse_capture_status reports the result.
+	   initialize_interrupt_table() must have been called before.
+  @warning Only one capture can run at a time.
+  @param[in] unsigned short pin_no, unsigned short level: HIGH or LOW, unsigned long timeout_us,
+	     unsigned char timer_no, unsigned int sample_clocks.
+  @param[Out] No output parameter.
+*/
+void GPIO_pulse_capture_start(US pin_no, US level, UL timeout_us, UC timer_no, UI sample_clocks) {
+
+	PULSE_CAPTURE_type *cap = &pulse_capture;
+
+	GPIO_config_pin(pin_no, GPIO_DIR_IN);
+
+	cap->data_addr = GPIO_PIN_REG(pin_no);
+	cap->level = level ? GPIO_PIN_MASK(pin_no) : 0;
+	cap->timer_no = timer_no;
+	cap->status = GPIO_PULSE_BUSY;
+	cap->state = PULSE_WAIT_START;
+	cap->deadline = time_now_cycles() + time_us_to_cycles(timeout_us);
+
+	timer_set_callback(timer_no, gpio_pulse_timer_isr, 0);
+	timer_run_in_intr_mode(timer_no, sample_clocks);
+	interrupt_enable(TIMER_IRQ(timer_no));
+}
 
+
+/** @fn GPIO_pulse_capture_status
+  @brief  Result of the interrupt driven pulse measurement.
+  @details Non blocking, call until the status is no longer GPIO_PULSE_BUSY.
+  @warning 
+  @param[in] unsigned long *width_us: pulse width when GPIO_PULSE_OK is returned.
+  @param[Out] GPIO_PULSE_BUSY, GPIO_PULSE_OK, GPIO_PULSE_NO_EDGE or GPIO_PULSE_TOO_LONG.
+*/
+UC GPIO_pulse_capture_status(UL *width_us) {
+
+	UC status = pulse_capture.status;
+
+	if(status == GPIO_PULSE_OK)
+		*width_us = (UL)time_cycles_to_us(pulse_capture.width);
+	return status;
+}
@@ -0,0 +1,251 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  input.c
+ * Brief Description of file             :  Debounced input manager.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+#include <include/stdlib.h>
+#include <include/gpio.h>
+#include <include/input.h>
+#include <include/timer.h>
+#include <include/interrupt.h>
+#include <include/config.h>
+#include <include/timebase.h>
+
+
+static struct
+{
+	UI mask;			// Managed pins, GPIO 1 in the upper half.
+	UI active_low;			// Pins inverted before debouncing.
+	UI ct0, ct1;			// Vertical counter, one bit of every pin each.
+	volatile UI state;		// Debounced state, 1 = pressed.
+	US hold_ticks;
+	US held[32];			// Ticks since the press, per pin.
+	INPUT_EVENT_type queue[INPUT_QUEUE_SIZE];
+	volatile UC head;		// Written by the ISR only.
+	volatile UC tail;		// Written by input_get_event only.
+	volatile UI dropped;
+	UC timer_no;
+}in;
+
+
+/** @fn input_queue
+  @brief  Queue an event.
+  @details Events are dropped and counted when the queue is full.
+  @warning
+  @param[in] unsigned char pin_no, unsigned char type, unsigned long long time
+  @param[Out] No output parameter.
+*/
+static void input_queue(UC pin_no, UC type, ULL time) {
+
+	UC head = in.head;
+	INPUT_EVENT_type *ev;
+
+	if((UC)(head - in.tail) >= INPUT_QUEUE_SIZE)
+	{
+		in.dropped++;
+		return;
+	}
+	ev = &in.queue[head & (INPUT_QUEUE_SIZE - 1)];
+	ev->pin_no = pin_no;
+	ev->type = type;
+	ev->time = time;
+	__asm__ __volatile__ ("fence" ::: "memory");
+	in.head = head + 1;
+}
+
+
+/** @fn input_timer_isr
+  @brief  Input tick.
+  @details Samples both ports and advances the vertical counter of every pin whose sample
+	   differs from its debounced state. A counter that reaches four toggles the state,
+	   any equal sample resets it.
+  @warning
+  @param[in] void *ctx: not used.
+  @param[Out] No output parameter.
+*/
+static void input_timer_isr(void *ctx) {
+
+	ULL now;
+	UI sample, changed, pressed;
+
+	now = time_now_cycles();
+	sample = GPIO_read_port(GPIO_0, (US)in.mask);
+	sample |= (UI)GPIO_read_port(GPIO_1, in.mask >> 16) << 16;
+	sample = (sample ^ in.active_low) & in.mask;
+
+	changed = sample ^ in.state;
+	in.ct0 = ~(in.ct0 & changed);
+	in.ct1 = in.ct0 ^ (in.ct1 & changed);
+	changed &= in.ct0 & in.ct1;			// Pins that differed for four samples.
+	in.state ^= changed;
+
+	while(changed)
+	{
+		UC pin_no = __builtin_ctz(changed);
+
+		changed &= changed - 1;
+		if(in.state & (1U << pin_no))
+		{
+			in.held[pin_no] = 0;
+			input_queue(pin_no, INPUT_EVENT_PRESS, now);
+		}
+		else
+			input_queue(pin_no, INPUT_EVENT_RELEASE, now);
+	}
+
+	if(in.hold_ticks == 0)
+		return;
+	pressed = in.state;
+	while(pressed)
+	{
+		UC pin_no = __builtin_ctz(pressed);
+
+		pressed &= pressed - 1;
+		if(++in.held[pin_no] >= in.hold_ticks)
+		{
+			in.held[pin_no] = 0;
+			input_queue(pin_no, INPUT_EVENT_HOLD, now);
+		}
+	}
+}
+
+
+/** @fn input_init
+  @brief  Initialise the input manager.
+  @details Removes all pins and empties the event queue.
+  @warning
+  @param[in] unsigned short hold_ticks: ticks a pin must stay pressed for a hold event,
+	     0 for no hold events.
+  @param[Out] No output parameter.
+*/
+void input_init(US hold_ticks) {
+
+	in.mask = 0;
+	in.active_low = 0;
+	in.ct0 = in.ct1 = ~0U;
+	in.state = 0;
+	in.hold_ticks = hold_ticks;
+	in.head = in.tail = 0;
+	in.dropped = 0;
+}
+
+
+/** @fn input_add
+  @brief  Add a pin to the input manager.
+  @details The pin is configured as INPUT. Call before input_start.
+  @warning
+  @param[in] unsigned short pin_no, unsigned char active: INPUT_ACTIVE_HIGH or INPUT_ACTIVE_LOW.
+  @param[Out] 0, or -1 if the pin is not on GPIO 0 or 1.
+*/
+int input_add(US pin_no, UC active) {
+
+	if(pin_no > PIN_31)
+		return -1;
+
+	in.mask |= 1U << pin_no;
+	if(active == INPUT_ACTIVE_LOW)
+		in.active_low |= 1U << pin_no;
+	else
+		in.active_low &= ~(1U << pin_no);
+
+	GPIO_set_dir(pin_no >> 4, GPIO_PIN_MASK(pin_no), GPIO_DIR_IN);
+	return 0;
+}
+
+
+/** @fn input_start
+  @brief  Start sampling the inputs.
+  @details Runs the input manager from the interrupt of timer_no. initialize_interrupt_table()
+	   must have been called before.
+  @warning A state change is reported after INPUT_DEBOUNCE_SAMPLES ticks, a tick of 5 ms
+	   gives 20 ms of debouncing.
+  @param[in] unsigned char timer_no, unsigned int tick_clocks
+  @param[Out] No output parameter.
+*/
+void input_start(UC timer_no, UI tick_clocks) {
+
+	in.timer_no = timer_no;
+
+	timer_set_callback(timer_no, input_timer_isr, 0);
+	timer_run_in_intr_mode(timer_no, tick_clocks);
+	interrupt_enable(TIMER_IRQ(timer_no));
+}
+
+
+/** @fn input_stop
+  @brief  Stop sampling the inputs.
+  @details Queued events can still be read.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+void input_stop(void) {
+
+	Timer(in.timer_no).Control = 0x0;	// Disable timer.
+	__asm__ __volatile__ ("fence");
+}
+
+
+/** @fn input_get_event
+  @brief  Take the oldest event from the queue.
+  @details Non blocking.
+  @warning
+  @param[in] INPUT_EVENT_type *event
+  @param[Out] 1 if an event was returned, 0 if the queue is empty.
+*/
+UC input_get_event(INPUT_EVENT_type *event) {
+
+	UC tail = in.tail;
+
+	if(tail == in.head)
+		return 0;
+	__asm__ __volatile__ ("fence" ::: "memory");
+	*event = in.queue[tail & (INPUT_QUEUE_SIZE - 1)];
+	__asm__ __volatile__ ("fence" ::: "memory");
+	in.tail = tail + 1;
+	return 1;
+}
+
+
+/** @fn input_state
+  @brief  Debounced state of all pins.
+  @details Bit n is set while pin n is pressed.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] Debounced state.
+*/
+UI input_state(void) {
+
+	return in.state;
+}
+
+
+/** @fn input_dropped
+  @brief  Number of events lost because the queue was full.
+  @details
+  @warning
+  @param[in] No input parameter.
+  @param[Out] Dropped events.
+*/
+UI input_dropped(void) {
+
+	return in.dropped;
+}
@@ -0,0 +1,215 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  keypad.c
+ * Brief Description of file             :  Interrupt driven matrix keypad scanner.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+#include <include/stdlib.h>
+#include <include/gpio.h>
+#include <include/keypad.h>
+#include <include/timer.h>
+#include <include/interrupt.h>
+#include <include/config.h>
+
+
+static struct
+{
+	US row_mask[2];			// Row pins, per port.
+	US row_value[KEYPAD_ROWS][2];	// Port levels selecting a row, per port.
+	US col_mask[2];			// Column pins, per port.
+	UC col_port[KEYPAD_COLS];
+	US col_bit[KEYPAD_COLS];
+	UC row;				// Row selected at the previous tick.
+	US scan;			// Keys seen pressed in the scan in progress.
+	US last_scan;			// Previous complete scan.
+	volatile US state;		// Debounced keys, bit row * KEYPAD_COLS + col.
+	UC queue[KEYPAD_QUEUE_SIZE];	// Key number, bit 7 set for a press.
+	volatile UC head;		// Written by the ISR only.
+	volatile UC tail;		// Written by keypad_get_event only.
+	UC timer_no;
+}kp;
+
+
+/** @fn keypad_timer_isr
+  @brief  Keypad tick.
+  @details Reads the columns of the selected row and selects the next one. After the last
+	   row the scan is compared with the previous one and changed keys are queued.
+  @warning
+  @param[in] void *ctx: not used.
+  @param[Out] No output parameter.
+*/
+static void keypad_timer_isr(void *ctx) {
+
+	US port[2];
+	US changed;
+	UC next;
+
+	port[0] = GPIO_read_port(GPIO_0, kp.col_mask[0]);
+	port[1] = GPIO_read_port(GPIO_1, kp.col_mask[1]);
+
+	next = (kp.row + 1 < KEYPAD_ROWS) ? kp.row + 1 : 0;
+	GPIO_write_port(GPIO_0, kp.row_mask[0], kp.row_value[next][0]);
+	GPIO_write_port(GPIO_1, kp.row_mask[1], kp.row_value[next][1]);
+
+	for(UC col = 0; col < KEYPAD_COLS; col++)
+		if(!(port[kp.col_port[col]] & kp.col_bit[col]))	// Pressed key pulls the column low.
+			kp.scan |= 1 << (kp.row * KEYPAD_COLS + col);
+	kp.row = next;
+	if(next != 0)
+		return;
+
+	changed = (kp.scan == kp.last_scan) ? (kp.scan ^ kp.state) : 0;
+	kp.last_scan = kp.scan;
+	kp.scan = 0;
+	kp.state ^= changed;
+
+	while(changed)
+	{
+		UC key = __builtin_ctz(changed);
+		UC head = kp.head;
+
+		changed &= changed - 1;
+		if((UC)(head - kp.tail) >= KEYPAD_QUEUE_SIZE)
+			continue;				// Full, the state is still updated.
+		kp.queue[head & (KEYPAD_QUEUE_SIZE - 1)] = key | ((kp.state & (1 << key)) ? 0x80 : 0);
+		__asm__ __volatile__ ("fence" ::: "memory");
+		kp.head = head + 1;
+	}
+}
+
+
+/** @fn keypad_init
+  @brief  Initialise the keypad scanner.
+  @details Configures the rows as OUTPUT, all high, and the columns as INPUT.
+  @warning The columns need pull-up resistors.
+  @param[in] unsigned short *row_pins: KEYPAD_ROWS pins, unsigned short *col_pins: KEYPAD_COLS pins.
+  @param[Out] 0, or -1 if a pin is not on GPIO 0 or 1.
+*/
+int keypad_init(const US *row_pins, const US *col_pins) {
+
+	for(UC r = 0; r < KEYPAD_ROWS; r++)
+		if(row_pins[r] > PIN_31)
+			return -1;
+	for(UC c = 0; c < KEYPAD_COLS; c++)
+		if(col_pins[c] > PIN_31)
+			return -1;
+
+	kp.row_mask[0] = kp.row_mask[1] = 0;
+	kp.col_mask[0] = kp.col_mask[1] = 0;
+	for(UC r = 0; r < KEYPAD_ROWS; r++)
+		kp.row_mask[row_pins[r] >> 4] |= GPIO_PIN_MASK(row_pins[r]);
+
+	for(UC r = 0; r < KEYPAD_ROWS; r++)
+	{
+		kp.row_value[r][0] = kp.row_mask[0];		// Other rows high.
+		kp.row_value[r][1] = kp.row_mask[1];
+		kp.row_value[r][row_pins[r] >> 4] &= ~GPIO_PIN_MASK(row_pins[r]);
+	}
+	for(UC c = 0; c < KEYPAD_COLS; c++)
+	{
+		kp.col_port[c] = col_pins[c] >> 4;
+		kp.col_bit[c] = GPIO_PIN_MASK(col_pins[c]);
+		kp.col_mask[kp.col_port[c]] |= kp.col_bit[c];
+	}
+
+	for(UC port = GPIO_0; port <= GPIO_1; port++)
+	{
+		GPIO_write_port(port, kp.row_mask[port], kp.row_mask[port]);
+		GPIO_set_dir(port, kp.row_mask[port], GPIO_DIR_OUT);
+		GPIO_set_dir(port, kp.col_mask[port], GPIO_DIR_IN);
+	}
+
+	kp.row = KEYPAD_ROWS - 1;
+	kp.scan = kp.last_scan = 0;
+	kp.state = 0;
+	kp.head = kp.tail = 0;
+	return 0;
+}
+
+
+/** @fn keypad_start
+  @brief  Start scanning the keypad.
+  @details Runs the scanner from the interrupt of timer_no. initialize_interrupt_table()
+	   must have been called before.
+  @warning A full scan takes KEYPAD_ROWS ticks and a key is debounced over two scans,
+	   a tick of 2 ms gives 16 ms of debouncing.
+  @param[in] unsigned char timer_no, unsigned int tick_clocks
+  @param[Out] No output parameter.
+*/
+void keypad_start(UC timer_no, UI tick_clocks) {
+
+	kp.timer_no = timer_no;
+
+	timer_set_callback(timer_no, keypad_timer_isr, 0);
+	timer_run_in_intr_mode(timer_no, tick_clocks);
+	interrupt_enable(TIMER_IRQ(timer_no));
+}
+
+
+/** @fn keypad_stop
+  @brief  Stop scanning the keypad.
+  @details
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+void keypad_stop(void) {
+
+	Timer(kp.timer_no).Control = 0x0;	// Disable timer.
+	__asm__ __volatile__ ("fence");
+}
+
+
+/** @fn keypad_get_event
+  @brief  Take the oldest key event.
+  @details Non blocking. Key numbers are row * KEYPAD_COLS + column.
+  @warning
+  @param[in] unsigned char *key, unsigned char *pressed: 1 for a press, 0 for a release.
+  @param[Out] 1 if an event was returned, 0 if there is none.
+*/
+UC keypad_get_event(UC *key, UC *pressed) {
+
+	UC tail = kp.tail;
+	UC ev;
+
+	if(tail == kp.head)
+		return 0;
+	__asm__ __volatile__ ("fence" ::: "memory");
+	ev = kp.queue[tail & (KEYPAD_QUEUE_SIZE - 1)];
+	__asm__ __volatile__ ("fence" ::: "memory");
+	kp.tail = tail + 1;
+
+	*key = ev & 0x7F;
+	*pressed = ev >> 7;
+	return 1;
+}
+
+
+/** @fn keypad_state
+  @brief  Debounced state of all keys.
+  @details Bit row * KEYPAD_COLS + column is set while the key is pressed.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] Key state.
+*/
+US keypad_state(void) {
+
+	return kp.state;
+}
@@ -0,0 +1,192 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  onewire.c
+ * Brief Description of file             :  1-Wire bus master.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+#include <include/stdlib.h>
+#include <include/gpio.h>
+#include <include/bitbang.h>
+#include <include/onewire.h>
+#include <include/config.h>
+#include <include/timebase.h>
+
+
+// Standard speed slot timing, in microseconds.
+#define ONEWIRE_RESET_LOW_US	480
+#define ONEWIRE_PRESENCE_US	70	// Presence sampled after the release.
+#define ONEWIRE_RESET_SLOT_US	480	// Release to end of the reset.
+#define ONEWIRE_WRITE1_LOW_US	6
+#define ONEWIRE_WRITE0_LOW_US	60
+#define ONEWIRE_SLOT_US		70	// Write slot including recovery.
+#define ONEWIRE_READ_LOW_US	6
+#define ONEWIRE_READ_SAMPLE_US	15	// From the start of the read slot.
+#define ONEWIRE_READ_SLOT_US	70
+
+#define onewire_low(pin_no)	GPIO_set_dir((pin_no) >> 4, GPIO_PIN_MASK(pin_no), GPIO_DIR_OUT)
+#define onewire_release(pin_no)	GPIO_set_dir((pin_no) >> 4, GPIO_PIN_MASK(pin_no), GPIO_DIR_IN)
+#define onewire_sense(pin_no)	GPIO_read_port((pin_no) >> 4, GPIO_PIN_MASK(pin_no))
+
+
+/** @fn onewire_init
+  @brief  Prepare a pin for a 1-Wire bus.
+  @details The data level is set low once, the pin is then only switched between OUTPUT
+	   (bus low) and INPUT (bus released).
+  @warning
+  @param[in] unsigned short pin_no
+  @param[Out] No output parameter.
+*/
+void onewire_init(US pin_no) {
+
+	onewire_release(pin_no);
+	GPIO_write_port(pin_no >> 4, GPIO_PIN_MASK(pin_no), 0);
+}
+
+
+/** @fn onewire_reset
+  @brief  Send a reset pulse and detect devices.
+  @details The reset low time is not critical and runs with interrupts enabled, only the
+	   release and the presence sample are timed.
+  @warning
+  @param[in] unsigned short pin_no
+  @param[Out] 1 if a device answered with a presence pulse, 0 otherwise.
+*/
+UC onewire_reset(US pin_no) {
+
+	UL mie, release;
+	UC presence;
+
+	onewire_low(pin_no);
+	bitbang_wait_until(time_now_cycles32() + TIME_US2CYC(ONEWIRE_RESET_LOW_US));
+
+	mie = bitbang_frame_begin();
+	onewire_release(pin_no);
+	release = time_now_cycles32();
+	bitbang_wait_until(release + TIME_US2CYC(ONEWIRE_PRESENCE_US));
+	presence = onewire_sense(pin_no) ? 0 : 1;
+	bitbang_frame_end(mie);
+
+	bitbang_wait_until(release + TIME_US2CYC(ONEWIRE_RESET_SLOT_US));
+	return presence;
+}
+
+
+/** @fn onewire_write_bit
+  @brief  Write one bit slot.
+  @details
+  @warning
+  @param[in] unsigned short pin_no, unsigned char bit
+  @param[Out] No output parameter.
+*/
+void onewire_write_bit(US pin_no, UC bit) {
+
+	UL mie, start;
+
+	mie = bitbang_frame_begin();
+	start = time_now_cycles32();
+	onewire_low(pin_no);
+	bitbang_wait_until(start + TIME_US2CYC(bit ? ONEWIRE_WRITE1_LOW_US : ONEWIRE_WRITE0_LOW_US));
+	onewire_release(pin_no);
+	bitbang_frame_end(mie);
+
+	bitbang_wait_until(start + TIME_US2CYC(ONEWIRE_SLOT_US));
+}
+
+
+/** @fn onewire_read_bit
+  @brief  Read one bit slot.
+  @details
+  @warning
+  @param[in] unsigned short pin_no
+  @param[Out] Bit read.
+*/
+UC onewire_read_bit(US pin_no) {
+
+	UL mie, start;
+	UC bit;
+
+	mie = bitbang_frame_begin();
+	start = time_now_cycles32();
+	onewire_low(pin_no);
+	bitbang_wait_until(start + TIME_US2CYC(ONEWIRE_READ_LOW_US));
+	onewire_release(pin_no);
+	bitbang_wait_until(start + TIME_US2CYC(ONEWIRE_READ_SAMPLE_US));
+	bit = onewire_sense(pin_no) ? 1 : 0;
+	bitbang_frame_end(mie);
+
+	bitbang_wait_until(start + TIME_US2CYC(ONEWIRE_READ_SLOT_US));
+	return bit;
+}
+
+
+/** @fn onewire_write_byte
+  @brief  Write a byte, LSB first.
+  @details
+  @warning
+  @param[in] unsigned short pin_no, unsigned char data
+  @param[Out] No output parameter.
+*/
+void onewire_write_byte(US pin_no, UC data) {
+
+	for(UC i = 0; i < 8; i++)
+	{
+		onewire_write_bit(pin_no, data & 1);
+		data >>= 1;
+	}
+}
+
+
+/** @fn onewire_read_byte
+  @brief  Read a byte, LSB first.
+  @details
+  @warning
+  @param[in] unsigned short pin_no
+  @param[Out] Byte read.
+*/
+UC onewire_read_byte(US pin_no) {
+
+	UC data = 0;
+
+	for(UC i = 0; i < 8; i++)
+		data |= onewire_read_bit(pin_no) << i;
+	return data;
+}
+
+
+/** @fn onewire_crc8
+  @brief  Dallas/Maxim CRC8 of a buffer.
+  @details Polynomial x^8 + x^5 + x^4 + 1. The CRC of a ROM code or scratchpad including its
+	   CRC byte is 0.
+  @warning
+  @param[in] unsigned char *data, unsigned char len
+  @param[Out] CRC.
+*/
+UC onewire_crc8(const UC *data, UC len) {
+
+	UC crc = 0;
+
+	while(len--)
+	{
+		crc ^= *data++;
+		for(UC i = 0; i < 8; i++)
+			crc = (crc & 1) ? (crc >> 1) ^ 0x8C : crc >> 1;
+	}
+	return crc;
+}
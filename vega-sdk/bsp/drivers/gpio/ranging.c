@@ -0,0 +1,332 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  ranging.c
+ * Brief Description of file             :  Concurrent ultrasonic ranging engine.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+#include <include/stdlib.h>
+#include <include/gpio.h>
+#include <include/ranging.h>
+#include <include/timer.h>
+#include <include/interrupt.h>
+#include <include/config.h>
+#include <include/timebase.h>
+
+
+#define RANGING_IDLE		0
+#define RANGING_TRIGGERED	1	// Trigger sent, waiting for the echo rising edge.
+#define RANGING_ECHO		2	// Echo high, waiting for the falling edge.
+
+typedef struct
+{
+	UC echo_port;
+	UC echo_bit;
+	UC trig_port;
+	US trig_mask;
+	UI fire_tick;
+	volatile UC state;
+	ULL rise;			// Time of the echo rising edge.
+	volatile US distance_mm;
+	volatile UI seq;		// Number of published readings.
+}RANGING_SENSOR_type;
+
+typedef struct
+{
+	UI tick;			// Tick in the ranging period.
+	US trig_mask[2];		// Trigger pins raised at this tick, per port.
+	UC sensors;			// Sensors fired at this tick, one bit each.
+}RANGING_EVENT_type;
+
+static struct
+{
+	RANGING_SENSOR_type sensor[RANGING_MAX_SENSORS];
+	RANGING_EVENT_type event[RANGING_MAX_EVENTS];	// Sorted by tick.
+	UC owner[2][16];		// Sensor index of each echo pin.
+	UC sensors;
+	UC events;
+	UC next_event;
+	UC timer_no;
+	UI period;
+	UI tick;
+	UI cyc2mm;			// Echo width in cycles to millimetres (half the round trip), 32.32.
+	ULL max_echo;			// RANGING_MAX_ECHO_US in cycles.
+	US echo_mask[2];
+	US echo_prev[2];
+	US trig_high[2];		// Trigger pins to lower at the next tick.
+}rng;
+
+
+/** @fn ranging_publish
+  @brief  Publish a reading.
+  @details Converts the echo width to millimetres, too long echoes are RANGING_NO_ECHO.
+  @warning
+  @param[in] sensor, unsigned long long width: echo width in cycles.
+  @param[Out] No output parameter.
+*/
+static void ranging_publish(RANGING_SENSOR_type *s, ULL width) {
+
+	if(width > rng.max_echo)
+		s->distance_mm = RANGING_NO_ECHO;
+	else
+		s->distance_mm = (US)((width * rng.cyc2mm) >> 32);
+	s->seq++;
+	s->state = RANGING_IDLE;
+}
+
+
+/** @fn ranging_edges
+  @brief  Handle the echo edges of one port.
+  @details Only called when at least one echo pin of the port changed.
+  @warning
+  @param[in] unsigned char port, unsigned short sample, unsigned long long now
+  @param[Out] No output parameter.
+*/
+static void ranging_edges(UC port, US sample, ULL now) {
+
+	US changed = sample ^ rng.echo_prev[port];
+
+	rng.echo_prev[port] = sample;
+	while(changed)
+	{
+		UC bit = __builtin_ctz(changed);
+		RANGING_SENSOR_type *s = &rng.sensor[rng.owner[port][bit]];
+
+		changed &= changed - 1;
+		if(sample & (1 << bit))
+		{
+			if(s->state == RANGING_TRIGGERED)
+			{
+				s->rise = now;
+				s->state = RANGING_ECHO;
+			}
+		}
+		else if(s->state == RANGING_ECHO)
+			ranging_publish(s, now - s->rise);
+	}
+}
+
+
+/** @fn ranging_timer_isr
+  @brief  Ranging tick.
+  @details Samples the echo pins of both ports, lowers the triggers raised at the previous
+	   tick and raises the triggers scheduled for this tick.
+  @warning
+  @param[in] void *ctx: not used.
+  @param[Out] No output parameter.
+*/
+static void ranging_timer_isr(void *ctx) {
+
+	ULL now;
+	US echo0, echo1;
+	RANGING_EVENT_type *ev;
+
+	now = time_now_cycles();
+	echo0 = GPIO_read_port(GPIO_0, rng.echo_mask[0]);
+	echo1 = GPIO_read_port(GPIO_1, rng.echo_mask[1]);
+
+	if(rng.trig_high[0] | rng.trig_high[1])
+	{
+		GPIO_write_port(GPIO_0, rng.trig_high[0], 0);	// End of the trigger pulse.
+		GPIO_write_port(GPIO_1, rng.trig_high[1], 0);
+		rng.trig_high[0] = rng.trig_high[1] = 0;
+	}
+
+	if(echo0 != rng.echo_prev[0])
+		ranging_edges(GPIO_0, echo0, now);
+	if(echo1 != rng.echo_prev[1])
+		ranging_edges(GPIO_1, echo1, now);
+
+	if(++rng.tick >= rng.period)
+		rng.tick = 0;
+
+	ev = &rng.event[rng.next_event];
+	if(rng.events == 0 || ev->tick != rng.tick)
+		return;
+
+	for(UC i = 0; i < rng.sensors; i++)
+	{
+		RANGING_SENSOR_type *s = &rng.sensor[i];
+
+		if(!(ev->sensors & (1 << i)))
+			continue;
+		if(s->state != RANGING_IDLE)
+			ranging_publish(s, rng.max_echo + 1);	// Previous echo never completed.
+		s->state = RANGING_TRIGGERED;
+	}
+	GPIO_write_port(GPIO_0, ev->trig_mask[0], ev->trig_mask[0]);
+	GPIO_write_port(GPIO_1, ev->trig_mask[1], ev->trig_mask[1]);
+	rng.trig_high[0] = ev->trig_mask[0];
+	rng.trig_high[1] = ev->trig_mask[1];
+
+	if(++rng.next_event >= rng.events)
+		rng.next_event = 0;
+}
+
+
+/** @fn ranging_init
+  @brief  Initialise the ranging engine.
+  @details Removes all sensors and sets the length of the trigger schedule.
+  @warning
+  @param[in] unsigned int period_ticks: ticks after which the schedule repeats.
+  @param[Out] No output parameter.
+*/
+void ranging_init(UI period_ticks) {
+
+	rng.sensors = 0;
+	rng.events = 0;
+	rng.next_event = 0;
+	rng.period = period_ticks;
+	rng.tick = 0;
+	rng.echo_mask[0] = rng.echo_mask[1] = 0;
+	rng.echo_prev[0] = rng.echo_prev[1] = 0;
+	rng.trig_high[0] = rng.trig_high[1] = 0;
+}
+
+
+/** @fn ranging_add
+  @brief  Add a sensor to the schedule.
+  @details The sensor is triggered at fire_tick of every period. Sensors sharing a
+	   fire_tick are triggered with the same port write. Call before ranging_start.
+  @warning Sensors fired together must not hear each other's echo.
+  @param[in] unsigned short trig_pin, unsigned short echo_pin, unsigned int fire_tick
+  @param[Out] Sensor index, or -1 if the table is full, a pin is not on GPIO 0 or 1 or the
+	      echo pin is in use.
+*/
+int ranging_add(US trig_pin, US echo_pin, UI fire_tick) {
+
+	RANGING_SENSOR_type *s;
+	UC index = rng.sensors;
+	UC e;
+
+	if(index >= RANGING_MAX_SENSORS || fire_tick >= rng.period)
+		return -1;
+	if(trig_pin > PIN_31 || echo_pin > PIN_31)
+		return -1;
+	if(rng.echo_mask[echo_pin >> 4] & GPIO_PIN_MASK(echo_pin))
+		return -1;
+
+	s = &rng.sensor[index];
+	s->echo_port = echo_pin >> 4;
+	s->echo_bit = echo_pin & 15;
+	s->trig_port = trig_pin >> 4;
+	s->trig_mask = GPIO_PIN_MASK(trig_pin);
+	s->fire_tick = fire_tick;
+	s->state = RANGING_IDLE;
+	s->distance_mm = RANGING_NO_ECHO;
+	s->seq = 0;
+
+	rng.owner[s->echo_port][s->echo_bit] = index;
+	rng.echo_mask[s->echo_port] |= GPIO_PIN_MASK(echo_pin);
+
+	for(e = 0; e < rng.events && rng.event[e].tick < fire_tick; e++)
+		;
+	if(e == rng.events || rng.event[e].tick != fire_tick)
+	{
+		for(UC j = rng.events; j > e; j--)	// Keep the events sorted by tick.
+			rng.event[j] = rng.event[j - 1];
+		rng.event[e].tick = fire_tick;
+		rng.event[e].trig_mask[0] = rng.event[e].trig_mask[1] = 0;
+		rng.event[e].sensors = 0;
+		rng.events++;
+	}
+	rng.event[e].trig_mask[s->trig_port] |= s->trig_mask;
+	rng.event[e].sensors |= (1 << index);
+
+	rng.sensors++;
+	return index;
+}
+
+
+/** @fn ranging_start
+  @brief  Start ranging.
+  @details Configures the pins and runs the engine from the interrupt of timer_no.
+	   initialize_interrupt_table() must have been called before. Echo widths are
+	   converted with the core clock of the time base, call delay_init() before to use
+	   the measured clock.
+  @warning tick_clocks must be at least 10 us, the minimum trigger pulse of the HC-SR04.
+	   The distance resolution is one tick (about 0.17 mm per us).
+  @param[in] unsigned char timer_no, unsigned int tick_clocks
+  @param[Out] No output parameter.
+*/
+void ranging_start(UC timer_no, UI tick_clocks) {
+
+	US trig[2] = { 0, 0 };
+
+	for(UC i = 0; i < rng.sensors; i++)
+		trig[rng.sensor[i].trig_port] |= rng.sensor[i].trig_mask;
+
+	for(UC port = GPIO_0; port <= GPIO_1; port++)
+	{
+		GPIO_write_port(port, trig[port], 0);
+		GPIO_set_dir(port, trig[port], GPIO_DIR_OUT);
+		GPIO_set_dir(port, rng.echo_mask[port], GPIO_DIR_IN);
+		rng.echo_prev[port] = GPIO_read_port(port, rng.echo_mask[port]);
+	}
+
+	rng.cyc2mm = (UI)(((ULL)(RANGING_SOUND_MM_S / 2) << 32) / time_scale.core_hz);
+	rng.max_echo = time_us_to_cycles(RANGING_MAX_ECHO_US);
+	rng.tick = rng.period - 1;		// First tick is tick 0.
+	rng.next_event = 0;
+	rng.timer_no = timer_no;
+
+	timer_set_callback(timer_no, ranging_timer_isr, 0);
+	timer_run_in_intr_mode(timer_no, tick_clocks);
+	interrupt_enable(TIMER_IRQ(timer_no));
+}
+
+
+/** @fn ranging_stop
+  @brief  Stop ranging.
+  @details
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+void ranging_stop(void) {
+
+	Timer(rng.timer_no).Control = 0x0;	// Disable timer.
+	__asm__ __volatile__ ("fence");
+}
+
+
+/** @fn ranging_read
+  @brief  Latest distance of a sensor.
+  @details Non blocking.
+  @warning
+  @param[in] unsigned char sensor, unsigned short *distance_mm: distance or RANGING_NO_ECHO.
+  @param[Out] Number of readings published so far, 0 if none yet or the sensor was not added.
+*/
+UI ranging_read(UC sensor, US *distance_mm) {
+
+	RANGING_SENSOR_type *s;
+	UI seq;
+
+	if(sensor >= rng.sensors)
+	{
+		*distance_mm = RANGING_NO_ECHO;
+		return 0;
+	}
+	s = &rng.sensor[sensor];
+	do {
+		seq = s->seq;
+		*distance_mm = s->distance_mm;
+	} while(seq != s->seq);
+	return seq;
+}
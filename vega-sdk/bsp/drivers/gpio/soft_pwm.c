@@ -0,0 +1,361 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  soft_pwm.c
+ * Brief Description of file             :  Timer driven multi-channel software PWM.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+#include <include/stdlib.h>
+#include <include/gpio.h>
+#include <include/soft_pwm.h>
+#include <include/timer.h>
+#include <include/interrupt.h>
+#include <include/config.h>
+
+
+typedef struct
+{
+	US at;				// Step in the PWM period.
+	US mask[2];			// Pins changing at this step, per port.
+	US value[2];			// New level of those pins.
+}SOFT_PWM_EDGE_type;
+
+typedef struct
+{
+	UC count;
+	SOFT_PWM_EDGE_type edge[SOFT_PWM_MAX_EDGES];	// edge[0] is always at step 0.
+}SOFT_PWM_LIST_type;
+
+typedef struct
+{
+	US pin_no;
+	US duty;			// High time in steps, 0 to steps.
+	US phase;			// Rising edge step, 0 to steps-1.
+}SOFT_PWM_CHANNEL_type;
+
+static struct
+{
+	SOFT_PWM_CHANNEL_type channel[SOFT_PWM_MAX_CHANNELS];
+	SOFT_PWM_LIST_type list[2];
+	SOFT_PWM_LIST_type *cur;			// List used by the ISR.
+	SOFT_PWM_LIST_type * volatile pending;		// List taken at the next period start.
+	UC channels;
+	UC timer_no;
+	UC index;					// Edge the timer is counting to.
+	US steps;
+	UI step_clocks;
+}pwm;
+
+
+/** @fn soft_pwm_delta
+  @brief  Timer clocks from an edge to the next one.
+  @details The edge after the last one is step 0 of the next period.
+  @warning
+  @param[in] list, unsigned char index
+  @param[Out] Timer clocks.
+*/
+static inline UI soft_pwm_delta(SOFT_PWM_LIST_type *list, UC index) {
+
+	US next = (index + 1 < list->count) ? list->edge[index + 1].at : pwm.steps;
+
+	return (next - list->edge[index].at) * pwm.step_clocks;
+}
+
+
+/** @fn soft_pwm_apply
+  @brief  Apply the edges of one step.
+  @details One masked store per port with changing pins.
+  @warning
+  @param[in] edge
+  @param[Out] No output parameter.
+*/
+static inline void soft_pwm_apply(SOFT_PWM_EDGE_type *e) {
+
+	if(e->mask[0])
+		*(volatile US *)(GPIO_0_BASE_ADDRESS + ((UL)e->mask[0] << 2)) = e->value[0];
+	if(e->mask[1])
+		*(volatile US *)(GPIO_1_BASE_ADDRESS + ((UL)e->mask[1] << 2)) = e->value[1];
+}
+
+
+/** @fn soft_pwm_advance
+  @brief  Move to the next edge.
+  @details At the end of the period a pending list replaces the current one, so a new
+	   set of duties always starts on a period boundary.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+static inline void soft_pwm_advance(void) {
+
+	if(++pwm.index >= pwm.cur->count)
+	{
+		pwm.index = 0;
+		if(pwm.pending)
+		{
+			pwm.cur = pwm.pending;
+			pwm.pending = 0;
+		}
+	}
+}
+
+
+/** @fn soft_pwm_timer_isr
+  @brief  Apply the edges due now.
+  @details The timer has already reloaded with the clocks to the next edge, so only the
+	   reload value for the edge after that is written. This keeps the edges free of
+	   interrupt latency as long as edges are at least SOFT_PWM_MIN_GAP_CLOCKS apart.
+  @warning
+  @param[in] void *ctx: not used.
+  @param[Out] No output parameter.
+*/
+static void soft_pwm_timer_isr(void *ctx) {
+
+	soft_pwm_apply(&pwm.cur->edge[pwm.index]);
+	soft_pwm_advance();
+	Timer(pwm.timer_no).LoadCount = soft_pwm_delta(pwm.cur, pwm.index);
+}
+
+
+/** @fn soft_pwm_add_edge
+  @brief  Add a pin change to a list under construction.
+  @details
+  @warning
+  @param[in] list, unsigned short at, unsigned short pin_no, unsigned char level
+  @param[Out] No output parameter.
+*/
+static void soft_pwm_add_edge(SOFT_PWM_LIST_type *list, US at, US pin_no, UC level) {
+
+	SOFT_PWM_EDGE_type *e;
+	UC port = pin_no >> 4;
+	UC i;
+
+	for(i = 0; i < list->count && list->edge[i].at < at; i++)
+		;
+	if(i == list->count || list->edge[i].at != at)
+	{
+		for(UC j = list->count; j > i; j--)		// Insertion keeps the list sorted.
+			list->edge[j] = list->edge[j - 1];
+		e = &list->edge[i];
+		e->at = at;
+		e->mask[0] = e->mask[1] = 0;
+		e->value[0] = e->value[1] = 0;
+		list->count++;
+	}
+	e = &list->edge[i];
+	e->mask[port] |= GPIO_PIN_MASK(pin_no);
+	if(level)
+		e->value[port] |= GPIO_PIN_MASK(pin_no);
+	else
+		e->value[port] &= ~GPIO_PIN_MASK(pin_no);
+}
+
+
+/** @fn soft_pwm_merge_close
+  @brief  Merge edges that are too close for the ISR.
+  @details An edge closer than SOFT_PWM_MIN_GAP_CLOCKS to the previous one is applied
+	   together with the previous one. An edge that close to the end of the period
+	   is applied with step 0 of the next period.
+  @warning
+  @param[in] list
+  @param[Out] No output parameter.
+*/
+static void soft_pwm_merge_close(SOFT_PWM_LIST_type *list) {
+
+	UC i = 1;
+
+	while(i < list->count)
+	{
+		SOFT_PWM_EDGE_type *prev = &list->edge[i - 1];
+		SOFT_PWM_EDGE_type *e = &list->edge[i];
+		SOFT_PWM_EDGE_type *first = &list->edge[0];
+
+		if((UI)(pwm.steps - e->at) * pwm.step_clocks < SOFT_PWM_MIN_GAP_CLOCKS)
+		{
+			for(UC port = 0; port < 2; port++)	// Step 0 changes come later, they win.
+			{
+				first->value[port] |= e->value[port] & ~first->mask[port];
+				first->mask[port] |= e->mask[port];
+			}
+		}
+		else if((UI)(e->at - prev->at) * pwm.step_clocks < SOFT_PWM_MIN_GAP_CLOCKS)
+		{
+			for(UC port = 0; port < 2; port++)
+			{
+				prev->value[port] = (prev->value[port] & ~e->mask[port]) | e->value[port];
+				prev->mask[port] |= e->mask[port];
+			}
+		}
+		else
+		{
+			i++;
+			continue;
+		}
+		for(UC j = i; j + 1 < list->count; j++)
+			list->edge[j] = list->edge[j + 1];
+		list->count--;
+	}
+}
+
+
+/** @fn soft_pwm_init
+  @brief  Initialise the software PWM.
+  @details
+  @warning period_clocks / steps is the step length in timer clocks.
+  @param[in] unsigned int period_clocks: PWM period in timer clocks, unsigned short steps: duty resolution.
+  @param[Out] No output parameter.
+*/
+void soft_pwm_init(UI period_clocks, US steps) {
+
+	pwm.channels = 0;
+	pwm.steps = steps;
+	pwm.step_clocks = period_clocks / steps;
+	pwm.cur = 0;
+	pwm.pending = 0;
+}
+
+
+/** @fn soft_pwm_add
+  @brief  Add a PWM channel.
+  @details The pin is configured as OUTPUT and driven low. The channel starts with duty 0.
+  @warning
+  @param[in] unsigned short pin_no
+  @param[Out] Channel number, or -1 if all channels are used or the pin is not on GPIO 0 or 1.
+*/
+int soft_pwm_add(US pin_no) {
+
+	SOFT_PWM_CHANNEL_type *ch;
+
+	if(pwm.channels >= SOFT_PWM_MAX_CHANNELS || pin_no > PIN_31)
+		return -1;
+
+	ch = &pwm.channel[pwm.channels];
+	ch->pin_no = pin_no;
+	ch->duty = 0;
+	ch->phase = 0;
+
+	GPIO_write_port(pin_no >> 4, GPIO_PIN_MASK(pin_no), 0);
+	GPIO_set_dir(pin_no >> 4, GPIO_PIN_MASK(pin_no), GPIO_DIR_OUT);
+	return pwm.channels++;
+}
+
+
+/** @fn soft_pwm_set
+  @brief  Set duty and phase of a channel.
+  @details Takes effect at the start of the period after soft_pwm_update().
+  @warning
+  @param[in] unsigned char channel, unsigned short duty: 0 to steps, unsigned short phase: 0 to steps-1.
+  @param[Out] No output parameter.
+*/
+void soft_pwm_set(UC channel, US duty, US phase) {
+
+	if(duty > pwm.steps)
+		duty = pwm.steps;
+	pwm.channel[channel].duty = duty;
+	pwm.channel[channel].phase = phase % pwm.steps;
+}
+
+
+/** @fn soft_pwm_update
+  @brief  Publish the duties and phases set with soft_pwm_set.
+  @details Builds the sorted edge list in the list the ISR is not using and hands it over
+	   at the next period start. Can be called while running.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+void soft_pwm_update(void) {
+
+	SOFT_PWM_LIST_type *list;
+
+	pwm.pending = 0;				// ISR keeps pwm.cur from here on.
+	__asm__ __volatile__ ("fence" ::: "memory");
+	list = (pwm.cur == &pwm.list[0]) ? &pwm.list[1] : &pwm.list[0];
+
+	list->count = 1;
+	list->edge[0].at = 0;
+	list->edge[0].mask[0] = list->edge[0].mask[1] = 0;
+	list->edge[0].value[0] = list->edge[0].value[1] = 0;
+
+	for(UC i = 0; i < pwm.channels; i++)
+	{
+		SOFT_PWM_CHANNEL_type *ch = &pwm.channel[i];
+		US fall = ch->phase + ch->duty;
+
+		if(fall >= pwm.steps)
+			fall -= pwm.steps;
+
+		if(ch->duty == 0)
+			soft_pwm_add_edge(list, ch->phase, ch->pin_no, LOW);
+		else if(ch->duty == pwm.steps)
+			soft_pwm_add_edge(list, ch->phase, ch->pin_no, HIGH);
+		else
+		{
+			soft_pwm_add_edge(list, ch->phase, ch->pin_no, HIGH);
+			soft_pwm_add_edge(list, fall, ch->pin_no, LOW);
+		}
+	}
+	soft_pwm_merge_close(list);
+
+	__asm__ __volatile__ ("fence" ::: "memory");
+	if(pwm.cur == 0)
+		pwm.cur = list;				// Not started yet.
+	else
+		pwm.pending = list;
+}
+
+
+/** @fn soft_pwm_start
+  @brief  Start the software PWM.
+  @details Runs the PWM from the interrupt of timer_no. initialize_interrupt_table() must
+	   have been called before.
+  @warning
+  @param[in] unsigned char timer_no
+  @param[Out] No output parameter.
+*/
+void soft_pwm_start(UC timer_no) {
+
+	if(pwm.cur == 0)
+		soft_pwm_update();
+
+	pwm.timer_no = timer_no;
+	pwm.index = 0;
+	timer_set_callback(timer_no, soft_pwm_timer_isr, 0);
+
+	soft_pwm_apply(&pwm.cur->edge[0]);
+	timer_run_in_intr_mode(timer_no, soft_pwm_delta(pwm.cur, 0));	// Counting to edge 1.
+	soft_pwm_advance();
+	(void)Timer(timer_no).CurrentValue;				// Counter has loaded.
+	Timer(timer_no).LoadCount = soft_pwm_delta(pwm.cur, pwm.index);	// Reload for the edge after.
+	interrupt_enable(TIMER_IRQ(timer_no));
+}
+
+
+/** @fn soft_pwm_stop
+  @brief  Stop the software PWM.
+  @details The pins keep their current level.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+void soft_pwm_stop(void) {
+
+	Timer(pwm.timer_no).Control = 0x0;	// Disable timer.
+	__asm__ __volatile__ ("fence");
+}
@@ -0,0 +1,71 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  ws2812.c
+ * Brief Description of file             :  WS2812 LED strip driver.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+#include <include/stdlib.h>
+#include <include/gpio.h>
+#include <include/bitbang.h>
+#include <include/ws2812.h>
+#include <include/config.h>
+#include <include/timebase.h>
+
+
+static BITBANG_SYMBOL_type ws2812_symbol;	// In core cycles, set by ws2812_init.
+
+static ULL ws2812_latched;		// Time after which the strip accepts a new frame.
+
+
+/** @fn ws2812_init
+  @brief  Prepare a pin for a WS2812 strip.
+  @details The pin is configured as OUTPUT and driven low. The bit timing is converted to
+	   core cycles with the clock of the time base, call delay_init() before to use the
+	   measured clock.
+  @warning
+  @param[in] unsigned short pin_no
+  @param[Out] No output parameter.
+*/
+void ws2812_init(US pin_no) {
+
+	GPIO_write_port(pin_no >> 4, GPIO_PIN_MASK(pin_no), 0);
+	GPIO_set_dir(pin_no >> 4, GPIO_PIN_MASK(pin_no), GPIO_DIR_OUT);
+	ws2812_symbol.t0h = (UI)time_ns_to_cycles(WS2812_T0H_NS);
+	ws2812_symbol.t1h = (UI)time_ns_to_cycles(WS2812_T1H_NS);
+	ws2812_symbol.period = (UI)time_ns_to_cycles(WS2812_PERIOD_NS);
+	ws2812_latched = time_now_cycles() + time_us_to_cycles(WS2812_RESET_US);
+}
+
+
+/** @fn ws2812_write
+  @brief  Send colours to a strip.
+  @details Waits for the reset time of the previous frame only if it has not passed yet,
+	   then sends the frame. The strip latches the colours WS2812_RESET_US later.
+  @warning Interrupts are masked while the frame is sent, 30 us per LED.
+  @param[in] unsigned short pin_no, unsigned char *grb: 3 bytes per LED, unsigned short leds
+  @param[Out] No output parameter.
+*/
+void ws2812_write(US pin_no, const UC *grb, US leds) {
+
+	while(time_now_cycles() < ws2812_latched)
+		;
+	bitbang_symbols(pin_no, grb, (UI)leds * 24, &ws2812_symbol);
+	ws2812_latched = time_now_cycles() + time_us_to_cycles(WS2812_RESET_US);
+}
@@ -0,0 +1,297 @@
+/***************************************************
+
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: i2c_sched.c
+ Purpose		: I2C sensor polling scheduler
+ Description		: Periodic I2C read transactions driven by a timer
+
+ See LICENSE for license details.
+ ***************************************************/
+
+/**
+ @file i2c_sched.c
+ @brief Contains routines for the I2C polling scheduler
+ @detail The timer interrupt only counts ticks and releases the devices
+ that are due, so it stays short. The bus transfers are done from
+ i2c_sched_poll(), which runs every released transaction back-to-back and
+ publishes each result through a per-device double buffer.
+ The ISR only writes 'released' and the poll loop only writes 'serviced',
+ so no interrupt masking is needed between the two.
+ */
+#include <include/stdlib.h>
+#include <include/i2c.h>
+#include <include/i2c_sched.h>
+#include <include/timer.h>
+#include <include/interrupt.h>
+#include <include/config.h>
+
+typedef struct {
+	I2C_SCHED_XFER xfer;
+	volatile UC active;
+	UI next_release;		// Tick of the next release, owned by the ISR.
+	volatile UI released;		// Releases so far, written by the ISR only.
+	UI serviced;			// Releases consumed, written by i2c_sched_poll() only.
+	UI overruns;			// Releases dropped because the previous one was not serviced.
+	UI errors;			// Transactions that ended with a NACK.
+	UC buf[2][I2C_SCHED_MAX_READ];	// Double buffer, buf[front] holds the latest sample.
+	volatile UC front;
+	volatile UI seq;		// Completed samples, bumped on every buffer flip.
+} I2C_SCHED_DEV;
+
+static I2C_SCHED_DEV sched_dev[I2C_SCHED_MAX_DEVICES];
+static volatile UI sched_ticks;
+static UC sched_timer;
+
+/**
+ @fn i2c_sched_timer_isr
+ @brief Scheduler tick
+ @details Releases every device whose period has elapsed.
+ @param[in] void *ctx: not used.
+ @param[Out] No output parameters.
+ @return Void function.
+ */
+static void i2c_sched_timer_isr(void *ctx) {
+	UI now;
+
+	now = ++sched_ticks;
+
+	for (int i = 0; i < I2C_SCHED_MAX_DEVICES; i++) {
+		I2C_SCHED_DEV *dev = &sched_dev[i];
+
+		if (dev->active && (int) (now - dev->next_release) >= 0) {
+			dev->released++;
+			dev->next_release += dev->xfer.period;
+		}
+	}
+}
+
+/**
+ @fn i2c_sched_transfer
+ @brief Runs one read transaction
+ @details Writes the register bytes (if any) and then reads read_length
+ bytes from the slave.
+ @param[in] I2C_SCHED_XFER *(xfer--transaction to run)
+ @param[in] unsigned char(*data--destination buffer)
+ @param[Out] No output parameters.
+ @return I2C_SCHED_OK on success, I2C_SCHED_NACK if the slave did not ACK
+ */
+static UC i2c_sched_transfer(const I2C_SCHED_XFER *xfer, UC *data) {
+	UC i2c_number = xfer->i2c_number;
+	UC address = (UC) (xfer->slave_address << 1);
+
+	if (xfer->reg_length) {
+		i2c_start(i2c_number, 0x00, 0);
+		if (i2c_data_write(i2c_number, &address, 1))
+			return I2C_SCHED_NACK; //received NACK, controller has sent stop
+		if (i2c_data_write(i2c_number, (UC *) xfer->reg, xfer->reg_length))
+			return I2C_SCHED_NACK;
+		i2c_stop(i2c_number);
+	}
+
+	address |= 0x01;
+	i2c_start(i2c_number, xfer->read_length, 1);
+	if (i2c_data_write(i2c_number, &address, 1))
+		return I2C_SCHED_NACK;
+	i2c_data_read(i2c_number, data, xfer->read_length);
+	return I2C_SCHED_OK;
+}
+
+/**
+ @fn i2c_sched_init
+ @brief Initializes the scheduler
+ @details Removes all devices and resets the tick counter.
+ @param[in] No input parameters.
+ @param[Out] No output parameters.
+ @return Void function.
+ */
+void i2c_sched_init(void) {
+	for (int i = 0; i < I2C_SCHED_MAX_DEVICES; i++)
+		sched_dev[i].active = 0;
+	sched_ticks = 0;
+}
+
+/**
+ @fn i2c_sched_add
+ @brief Registers a device
+ @details The transaction is copied, so the caller's structure can be
+ reused. The first release happens 'phase' ticks from now.
+ @param[in] I2C_SCHED_XFER *(xfer--transaction and period)
+ @param[Out] No output parameters.
+ @return device handle, or -1 if the table is full or xfer is invalid
+ */
+int i2c_sched_add(const I2C_SCHED_XFER *xfer) {
+	if (xfer->period == 0 || xfer->read_length == 0
+			|| xfer->read_length > I2C_SCHED_MAX_READ
+			|| xfer->reg_length > I2C_SCHED_MAX_REG)
+		return -1;
+
+	for (int i = 0; i < I2C_SCHED_MAX_DEVICES; i++) {
+		I2C_SCHED_DEV *dev = &sched_dev[i];
+
+		if (dev->active)
+			continue;
+		dev->xfer = *xfer;
+		dev->next_release = sched_ticks + xfer->phase;
+		dev->serviced = dev->released;
+		dev->overruns = 0;
+		dev->errors = 0;
+		dev->front = 0;
+		dev->seq = 0;
+		__asm__ __volatile__ ("fence" ::: "memory");
+		dev->active = 1;			// Visible to the ISR only once set up.
+		return i;
+	}
+	return -1;
+}
+
+/**
+ @fn i2c_sched_remove
+ @brief Unregisters a device
+ @param[in] unsigned char(dev--handle from i2c_sched_add)
+ @param[Out] No output parameters.
+ @return Void function.
+ */
+void i2c_sched_remove(UC dev) {
+	if (dev < I2C_SCHED_MAX_DEVICES)
+		sched_dev[dev].active = 0;
+}
+
+/**
+ @fn i2c_sched_start
+ @brief Starts the scheduler tick
+ @details Hooks the selected timer interrupt and runs the timer
+ periodically with tick_clocks. initialize_interrupt_table() must have
+ been called before.
+ @param[in] unsigned char(timer_no--TIMER_0 to TIMER_2)
+ @param[in] unsigned int(tick_clocks--timer clocks per scheduler tick)
+ @param[Out] No output parameters.
+ @return Void function.
+ */
+void i2c_sched_start(UC timer_no, UI tick_clocks) {
+	sched_timer = timer_no;
+	timer_set_callback(timer_no, i2c_sched_timer_isr, 0);
+	timer_run_in_intr_mode(timer_no, tick_clocks);
+	interrupt_enable(TIMER_IRQ(timer_no));
+}
+
+/**
+ @fn i2c_sched_stop
+ @brief Stops the scheduler tick
+ @details Pending releases are still serviced by i2c_sched_poll().
+ @param[in] No input parameters.
+ @param[Out] No output parameters.
+ @return Void function.
+ */
+void i2c_sched_stop(void) {
+	Timer(sched_timer).Control = 0x0;	// Disable timer.
+	__asm__ __volatile__ ("fence" ::: "memory");
+}
+
+/**
+ @fn i2c_sched_poll
+ @brief Runs all released transactions
+ @details Call from the main loop. The released transactions run one
+ after another without idle time on the bus. A device released more than
+ once since the last poll is read once and the extra releases are counted
+ as overruns.
+ @param[in] No input parameters.
+ @param[Out] No output parameters.
+ @return number of transactions run
+ */
+UC i2c_sched_poll(void) {
+	UC done = 0;
+
+	for (int i = 0; i < I2C_SCHED_MAX_DEVICES; i++) {
+		I2C_SCHED_DEV *dev = &sched_dev[i];
+		UI pending;
+		UC back;
+
+		if (!dev->active)
+			continue;
+		pending = dev->released - dev->serviced;
+		if (pending == 0)
+			continue;
+		dev->overruns += pending - 1;
+		dev->serviced += pending;
+
+		back = dev->front ^ 1;
+		if (i2c_sched_transfer(&dev->xfer, dev->buf[back]) == I2C_SCHED_OK) {
+			__asm__ __volatile__ ("fence" ::: "memory");
+			dev->front = back;
+			dev->seq++;
+		} else
+			dev->errors++;
+		done++;
+	}
+	return done;
+}
+
+/**
+ @fn i2c_sched_valid
+ @brief Checks a device handle
+ @param[in] unsigned char(dev--handle from i2c_sched_add)
+ @param[Out] No output parameters.
+ @return 1 if dev is a registered device, 0 otherwise
+ */
+static inline UC i2c_sched_valid(UC dev) {
+	return dev < I2C_SCHED_MAX_DEVICES && sched_dev[dev].active;
+}
+
+/**
+ @fn i2c_sched_read
+ @brief Copies the latest sample of a device
+ @details The copy is retried if a new sample is published while copying,
+ so the result is never a mix of two samples.
+ @param[in] unsigned char(dev--handle from i2c_sched_add)
+ @param[in] unsigned char(*data--destination, read_length bytes)
+ @param[Out] No output parameters.
+ @return sample number (0 if no sample completed yet or dev is not registered)
+ */
+UI i2c_sched_read(UC dev, UC *data) {
+	I2C_SCHED_DEV *d;
+	UI seq;
+
+	if (!i2c_sched_valid(dev))
+		return 0;
+	d = &sched_dev[dev];
+	do {
+		UC *src;
+
+		seq = d->seq;
+		src = d->buf[d->front];
+		for (int i = 0; i < d->xfer.read_length; i++)
+			data[i] = src[i];
+		__asm__ __volatile__ ("fence" ::: "memory");
+	} while (seq != d->seq);
+
+	return seq;
+}
+
+/**
+ @fn i2c_sched_errors
+ @brief Number of NACKed transactions of a device
+ @param[in] unsigned char(dev--handle from i2c_sched_add)
+ @param[Out] No output parameters.
+ @return error count (0 if dev is not registered)
+ */
+UI i2c_sched_errors(UC dev) {
+	if (!i2c_sched_valid(dev))
+		return 0;
+	return sched_dev[dev].errors;
+}
+
+/**
+ @fn i2c_sched_overruns
+ @brief Number of releases of a device dropped by a late poll
+ @param[in] unsigned char(dev--handle from i2c_sched_add)
+ @param[Out] No output parameters.
+ @return overrun count (0 if dev is not registered)
+ */
+UI i2c_sched_overruns(UC dev) {
+	if (!i2c_sched_valid(dev))
+		return 0;
+	return sched_dev[dev].overruns;
+}
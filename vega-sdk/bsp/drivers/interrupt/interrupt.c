@@ -27,10 +27,98 @@
 #include <include/timer.h>
 #include <include/config.h>
 #include <include/encoding.h>
+#include <include/irq_stats.h>
 
 
-extern int INTERRUPT_Handler_0;
-fp interrupt_table[64]; //Array of Function pointer.
+extern int INTERRUPT_Vector_Table;
+extern int INTERRUPT_Direct_Entry;
+IRQ_ENTRY_type irq_table[INTR_SOURCES] = { [0 ... INTR_SOURCES - 1] = { interrupt_unhandled, 0 } };
+volatile ULL interrupt_unhandled_lines;		// Lines disabled by interrupt_unhandled.
+
+static UC irq_priority[INTR_SOURCES];		// IRQ_PRIORITY_LOWEST until registered.
+static ULL irq_prio_mask[IRQ_PRIORITIES] = { [IRQ_PRIORITY_LOWEST] = ~0ULL };	// Lines of each priority.
+static ULL irq_below_mask[IRQ_PRIORITIES] = { [0 ... IRQ_PRIORITIES - 1] = ~0ULL };	// Lines of the priority and below.
+
+static ULL irq_en;				// Lines enabled by interrupt_enable.
+static ULL irq_masked;				// Lines held off by the nested handlers running.
+static UC irq_nest;				// Nesting on.
+static volatile UC irq_cur = IRQ_PRIORITY_LOWEST;	// Priority being dispatched, lowest in the foreground.
+
+/* Index of the lowest set bit: x & -x isolates it and the multiplication
+*  shifts a de Bruijn sequence by that amount, whose top bits are unique.
+*/
+static const UC debruijn32[32] = {
+	0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+	31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+};
+
+#if __riscv_xlen == 64
+static const UC debruijn64[64] = {
+	0, 1, 2, 7, 3, 13, 8, 19, 4, 25, 14, 28, 9, 34, 20, 40,
+	5, 17, 26, 38, 15, 46, 29, 48, 10, 31, 35, 54, 21, 50, 41, 57,
+	63, 6, 12, 18, 24, 27, 33, 39, 16, 37, 45, 47, 30, 53, 49, 56,
+	62, 11, 23, 32, 36, 44, 52, 55, 61, 22, 43, 51, 60, 42, 59, 58
+};
+#endif
+
+
+/** @fn irq_lowest
+ @brief  Lowest pending source.
+ @details de Bruijn lookup of the lowest set bit, one lookup per word.
+ @warning pending must not be 0.
+ @param[in] unsigned long long pending
+ @param[Out] Source number.
+*/
+static inline UC irq_lowest(ULL pending) {
+
+#if __riscv_xlen == 64
+	return debruijn64[((pending & -pending) * 0x0218A392CD3D5DBFUL) >> 58];
+#else
+	UI lo = (UI)pending, hi = (UI)(pending >> 32);
+
+	if(lo)
+		return debruijn32[((lo & -lo) * 0x077CB531U) >> 27];
+	return 32 + debruijn32[((hi & -hi) * 0x077CB531U) >> 27];
+#endif
+}
+
+
+/** @fn irq_status
+ @brief  Read the pending sources.
+ @details
+ @warning 
+ @param[in] No input parameter.
+ @param[Out] One bit per pending source.
+*/
+static inline ULL irq_status(void) {
+
+#if __riscv_xlen == 64
+	return intr_regs.INTR_STATUS;
+#else
+	return ((ULL)intr_regs.INTR_STATUS_H << 32) | intr_regs.INTR_STATUS;
+#endif
+}
+
+
+/** @fn irq_write_en
+ @brief  Update the enable register.
+ @details Enabled lines that no running handler holds off.
+ @warning Call with MIE clear.
+ @param[in] No input parameter.
+ @param[Out] No output parameter.
+*/
+static inline void irq_write_en(void) {
+
+	ULL en = irq_en & ~irq_masked;
+
+#if __riscv_xlen == 64
+	intr_regs.INTR_EN = en;
+#else
+	intr_regs.INTR_EN = (UI)en;
+	intr_regs.INTR_EN_H = (UI)(en >> 32);
+#endif
+	__asm__ __volatile__ ("fence");
+}
 
 
 /** @fn    enable_irq
@@ -55,8 +143,30 @@ void enable_irq(void) {
 
 void interrupt_enable(UC intr_number)
 {
-	intr_regs.INTR_EN |= (1 << intr_number);	// Enable interrupt for peripheral in interrupt controller.
-	__asm__ __volatile__ ("fence");
+	UL mie = clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+
+	irq_en |= (1ULL << intr_number);		// Enable interrupt for peripheral in interrupt controller.
+	irq_write_en();
+	if(mie)
+		set_csr(mstatus, MSTATUS_MIE);
+}
+
+/** @fn interrupt_disable
+  @brief  Disable interrupt in controller.
+  @details The enable bit of the peripheral selected is cleared, other peripherals keep interrupting.
+  @warning 
+  @param[in] unsigned char intr_number: The number at which the periphral will interrupt
+  @param[Out] No output parameter.
+*/
+
+void interrupt_disable(UC intr_number)
+{
+	UL mie = clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+
+	irq_en &= ~(1ULL << intr_number);		// Disable interrupt for peripheral in interrupt controller.
+	irq_write_en();
+	if(mie)
+		set_csr(mstatus, MSTATUS_MIE);
 }
 
  
@@ -70,40 +180,237 @@ void interrupt_enable(UC intr_number)
 
 void initialize_interrupt_table(void)
 {
+	write_csr(mtvec,(UL)&INTERRUPT_Vector_Table | 1);	// Vectored mode, exceptions keep trap_entry.
+	if((read_csr(mtvec) & 3) != 1)				// Mode is WARL, not every core has vectors.
+		write_csr(mtvec,(UL)&INTERRUPT_Direct_Entry);
+
+	for(UL i = 0; i < TIMER_COUNT; i++)		// One handler for the three timers.
+		irq_register(TIMER_IRQ(i), timer_intr_handler, (void *)i, IRQ_PRIORITY_DEFAULT);
+
 	enable_irq();	// Enable global interrupt and external interrupt of the processor.
+}
 
-#if __riscv_xlen == 64
-	//For 64 Bit processors			
-	write_csr(mtvec,(UL)&INTERRUPT_Handler_0);		// Set MTVEC register with vector address.
-	interrupt_table[10] = timer0_intr_handler; 	// Timer0 interrupt numer is 10 for 64 bit processor.
-	interrupt_table[11] = timer1_intr_handler; 	// Timer1 interrupt numer is 11 for 64 bit processor.
-	interrupt_table[12] = timer2_intr_handler;	// Timer2 interrupt numer is 12 for 64 bit processor.
-#else
-	//For32 Bit processors
-	write_csr(mtvec,(UI)&INTERRUPT_Handler_0);		// Set MTVEC register with vector address.
-	interrupt_table[7] = timer0_intr_handler; 	// Timer0 interrupt numer is 7 for 64 bit processor.
-	interrupt_table[8] = timer1_intr_handler; 	// Timer1 interrupt numer is 8 for 64 bit processor.
-	interrupt_table[9] = timer2_intr_handler;	// Timer2 interrupt numer is 9 for 64 bit processor.
-#endif
+
+/** @fn irq_set_priority
+ @brief  Set the priority of a source.
+ @details Pending sources are served from IRQ_PRIORITY_HIGHEST down, in source order within a priority.
+ @warning 
+ @param[in] unsigned char irq, unsigned char priority: raised to IRQ_PRIORITY_HIGHEST if above.
+ @param[Out] No output parameter.
+*/
+void irq_set_priority(UC irq, UC priority) {
+
+	ULL bit = 1ULL << irq;
+	UL mie;
+
+	if(irq >= INTR_SOURCES)
+		return;
+	if(priority > IRQ_PRIORITY_HIGHEST)
+		priority = IRQ_PRIORITY_HIGHEST;
+
+	mie = clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+	irq_prio_mask[irq_priority[irq]] &= ~bit;
+	irq_prio_mask[priority] |= bit;
+	irq_priority[irq] = priority;
+	for(UC p = 0; p < IRQ_PRIORITIES; p++)
+		irq_below_mask[p] = irq_prio_mask[p] | (p ? irq_below_mask[p - 1] : 0);
+	if(mie)
+		set_csr(mstatus, MSTATUS_MIE);
+}
+
+
+/** @fn irq_register
+ @brief  Attach a handler to an interrupt source.
+ @details handler is called with ctx whenever the source is pending, so one handler can serve several instances of
+	  a peripheral. A handler already attached is replaced. The line is not enabled here, see interrupt_enable().
+ @warning The handler must clear the interrupt in its peripheral.
+ @param[in] unsigned char irq, irq_handler handler, void *ctx, unsigned char priority
+ @param[Out] No output parameter.
+*/
+void irq_register(UC irq, irq_handler handler, void *ctx, UC priority) {
+
+	UL mie;
+
+	if(irq >= INTR_SOURCES)
+		return;
+
+	mie = clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+	irq_table[irq].handler = handler ? handler : interrupt_unhandled;
+	irq_table[irq].ctx = ctx;
+	if(mie)
+		set_csr(mstatus, MSTATUS_MIE);
+	irq_set_priority(irq, priority);
+}
+
+
+/** @fn irq_unregister
+ @brief  Detach the handler of an interrupt source.
+ @details The line is disabled and gets the default handler back.
+ @warning 
+ @param[in] unsigned char irq
+ @param[Out] No output parameter.
+*/
+void irq_unregister(UC irq) {
+
+	if(irq >= INTR_SOURCES)
+		return;
+
+	interrupt_disable(irq);
+	irq_register(irq, 0, 0, IRQ_PRIORITY_LOWEST);
 }
 
  
+/** @fn irq_nesting
+ @brief  Turn nested interrupts on or off.
+ @details With nesting, a handler runs with interrupts enabled and the lines of its priority and below held off in the
+	  controller, so a source of higher priority preempts it. Without, a handler runs to the end first.
+ @warning The handlers of nesting priorities run with MIE set, a handler that shares data with a higher priority
+	  one has to mask it, see interrupt_disable().
+ @param[in] unsigned char enable
+ @param[Out] No output parameter.
+*/
+void irq_nesting(UC enable) {
+
+	irq_nest = enable;
+}
+
+
+/** @fn irq_run_nested
+ @brief  Run a handler with higher priorities enabled.
+ @details mepc and mstatus are kept on the stack, a nested trap overwrites them and the interrupt entry returns
+	  with them.
+ @warning 
+ @param[in] IRQ_ENTRY_type *entry, unsigned long long mask: lines to hold off.
+ @param[Out] No output parameter.
+*/
+static void irq_run_nested(IRQ_ENTRY_type *entry, ULL mask) {
+
+	UL epc = read_csr(mepc);
+	UL status = read_csr(mstatus);
+
+	mask &= ~irq_masked;				// Not already held off by an outer level.
+	irq_masked |= mask;
+	irq_write_en();
+
+	set_csr(mstatus, MSTATUS_MIE);
+	entry->handler(entry->ctx);
+	clear_csr(mstatus, MSTATUS_MIE);
+
+	irq_masked &= ~mask;
+	irq_write_en();
+	write_csr(mepc, epc);
+	write_csr(mstatus, status);
+}
+
+
+/** @fn irq_current_priority
+ @brief  Priority of the handler running.
+ @details The priority interrupt_handler is dispatching, as set with irq_register or irq_set_priority.
+ @warning 
+ @param[in] No input parameter.
+ @param[Out] Priority, IRQ_PRIORITY_LOWEST outside interrupt handlers.
+*/
+UC irq_current_priority(void) {
+
+	return irq_cur;
+}
+
+
 /** @fn interrupt_handler
  @brief  Invoke the peripheral interrupt handler.
- @details The interrupt controller's status register is read to identify the interrupted peripheral and then the corresponding
-	  handler for the peripheral is invoked.
+ @details The interrupt controller's status register is read to identify the interrupted peripherals and the handler of
+	  each pending source is invoked, highest priority first. Pending sources are found with a de Bruijn lookup of
+	  the lowest set bit, so the cost depends on the number of pending sources, not on the number of lines.
  @warning 
  @param[in] No input parameter.
  @param[Out] No output parameter.
 */
 void interrupt_handler(void){
 
-	UI intr_status = intr_regs.INTR_STATUS; 		// Read interrupt status register.
+#ifdef VEGA_IRQ_STATS
+	UI stats_entry = irq_stats_entry;			// Before a nested entry overwrites it.
+	UI stats_start;
+#endif
+	ULL status = irq_status(); 				// Read interrupt status register.
+	UC prev = irq_cur;					// Priority of the level interrupted.
+	ULL pending;
+	IRQ_ENTRY_type *entry;
+	UC irq;
+	int p;
+
+	for(p = IRQ_PRIORITY_HIGHEST; p >= 0 && status; p--)
+	{
+		pending = status & irq_prio_mask[p];
+		status &= ~pending;
+		while(pending)
+		{
+			irq = irq_lowest(pending);
+			entry = &irq_table[irq];
+#ifdef VEGA_IRQ_STATS
+			stats_start = read_csr(mcycle);
+#endif
+			irq_cur = p;
+			if(irq_nest && p < IRQ_PRIORITY_HIGHEST)
+				irq_run_nested(entry, irq_below_mask[p]);
+			else
+				entry->handler(entry->ctx);	// Invoke the peripheral handler.
+#ifdef VEGA_IRQ_STATS
+			irq_stats_record(irq, stats_entry, stats_start, read_csr(mcycle));
+#endif
+			pending &= pending - 1;			// Clear the lowest pending source.
+		}
+	}
+	irq_cur = prev;
+}
+
+
+/** @fn machine_timer_interrupt_handler
+ @brief  Core timer interrupt handler.
+ @details Entered directly from the machine timer vector. The core timer interrupt is not enabled by the BSP, this
+	  default disables it again. Override it to use the core timer.
+ @warning 
+ @param[in] No input parameter.
+ @param[Out] No output parameter.
+*/
+void __attribute__((weak)) machine_timer_interrupt_handler(void){
+
+	clear_csr(mie, MIP_MTIP);
+}
+
+
+/** @fn software_interrupt_handler
+ @brief  Software interrupt handler.
+ @details Entered directly from the machine software vector. The software interrupt is not enabled by the BSP, this
+	  default disables it again. Override it to use software interrupts.
+ @warning 
+ @param[in] No input parameter.
+ @param[Out] No output parameter.
+*/
+void __attribute__((weak)) software_interrupt_handler(void){
+
+	clear_csr(mie, MIP_MSIP);
+}
+
+
+/** @fn interrupt_unhandled
+ @brief  Default handler of the sources without one.
+ @details The source cannot be cleared without knowing the peripheral, so its line is disabled instead of
+	  interrupting again forever, and recorded in interrupt_unhandled_lines.
+ @warning 
+ @param[in] void *ctx: not used.
+ @param[Out] No output parameter.
+*/
+void interrupt_unhandled(void *ctx){
+
+	ULL pending = irq_status();
 
-	for(int i = 0; i < 32; i++) 
+	for(UC i = 0; i < INTR_SOURCES; i++)
 	{
-		if ((intr_status >> i) & 1)
-			interrupt_table[i]();		// Invoke the peripheral handler as function pointer.
+		if(((pending >> i) & 1) && irq_table[i].handler == interrupt_unhandled)
+		{
+			interrupt_disable(i);
+			interrupt_unhandled_lines |= (1ULL << i);
+		}
 	}
 }
 
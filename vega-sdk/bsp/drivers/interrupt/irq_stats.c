@@ -0,0 +1,157 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  irq_stats.c
+ * Brief Description of file             :  Interrupt latency and duration statistics.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+
+#include <include/stdlib.h>
+#include <include/irq_stats.h>
+#include <include/interrupt.h>
+#include <include/config.h>
+#include <include/encoding.h>
+
+#ifdef VEGA_IRQ_STATS
+
+volatile UI irq_stats_entry;
+static IRQ_STATS_type irq_stats[INTR_SOURCES];
+
+
+/** @fn irq_stats_bin
+  @brief  Histogram bin of a cycle count.
+  @details
+  @warning
+  @param[in] unsigned int cycles
+  @param[Out] Bin, 0 to IRQ_STATS_BINS - 1.
+*/
+static inline UC irq_stats_bin(UI cycles) {
+
+	UC bin = 0;
+
+	cycles >>= IRQ_STATS_BIN0_SHIFT;
+	while(cycles && bin < IRQ_STATS_BINS - 1)
+	{
+		cycles >>= 1;
+		bin++;
+	}
+	return bin;
+}
+
+
+/** @fn irq_stats_record
+  @brief  Record one handler run.
+  @details Called by interrupt_handler with interrupts masked.
+  @warning
+  @param[in] unsigned char irq, unsigned int entry, start, end: mcycle at the interrupt
+	     entry, before and after the handler.
+  @param[Out] No output parameter.
+*/
+void irq_stats_record(UC irq, UI entry, UI start, UI end) {
+
+	IRQ_STATS_type *s = &irq_stats[irq];
+	UI lat = start - entry;
+	UI svc = end - start;
+
+	if(s->count == 0 || lat < s->lat_min)
+		s->lat_min = lat;
+	if(lat > s->lat_max)
+		s->lat_max = lat;
+	if(s->count == 0 || svc < s->svc_min)
+		s->svc_min = svc;
+	if(svc > s->svc_max)
+		s->svc_max = svc;
+	s->lat_sum += lat;
+	s->svc_sum += svc;
+	s->lat_hist[irq_stats_bin(lat)]++;
+	s->svc_hist[irq_stats_bin(svc)]++;
+	s->count++;
+}
+
+
+/** @fn irq_stats_reset
+  @brief  Clear the statistics of every source.
+  @details
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+void irq_stats_reset(void) {
+
+	UL mie = clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+	UC *p = (UC *)irq_stats;
+
+	for(UI i = 0; i < sizeof(irq_stats); i++)
+		p[i] = 0;
+	if(mie)
+		set_csr(mstatus, MSTATUS_MIE);
+}
+
+
+/** @fn irq_stats_get
+  @brief  Statistics of one source.
+  @details
+  @warning Read while interrupts of the source are running, the fields may not match.
+  @param[in] unsigned char irq
+  @param[Out] Statistics, 0 for an invalid source.
+*/
+const IRQ_STATS_type *irq_stats_get(UC irq) {
+
+	if(irq >= INTR_SOURCES)
+		return 0;
+	return &irq_stats[irq];
+}
+
+
+/** @fn irq_stats_dump
+  @brief  Print the statistics over the debug UART.
+  @details One block per source that has interrupted, in cycles. A copy is taken with
+	   interrupts masked, printing runs with them enabled.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+void irq_stats_dump(void) {
+
+	IRQ_STATS_type s;
+	UL mie;
+
+	printf("\n\r IRQ statistics, cycles");
+	for(UC irq = 0; irq < INTR_SOURCES; irq++)
+	{
+		mie = clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+		s = irq_stats[irq];
+		if(mie)
+			set_csr(mstatus, MSTATUS_MIE);
+		if(s.count == 0)
+			continue;
+
+		printf("\n\r irq %d: %u runs", irq, s.count);
+		printf("\n\r  latency min %u mean %u max %u", s.lat_min, (UI)(s.lat_sum / s.count), s.lat_max);
+		printf("\n\r  service min %u mean %u max %u", s.svc_min, (UI)(s.svc_sum / s.count), s.svc_max);
+		printf("\n\r  latency hist");
+		for(UC b = 0; b < IRQ_STATS_BINS; b++)
+			printf(" %u", s.lat_hist[b]);
+		printf("\n\r  service hist");
+		for(UC b = 0; b < IRQ_STATS_BINS; b++)
+			printf(" %u", s.svc_hist[b]);
+	}
+}
+
+#endif /* VEGA_IRQ_STATS */
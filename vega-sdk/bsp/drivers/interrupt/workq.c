@@ -0,0 +1,179 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  workq.c
+ * Brief Description of file             :  Deferred interrupt work queue.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+
+#include <include/stdlib.h>
+#include <include/workq.h>
+#include <include/interrupt.h>
+#include <include/config.h>
+#include <include/encoding.h>
+
+
+typedef struct
+{
+	WORKQ_ITEM_type item[WORKQ_DEPTH];
+	volatile UI head;		// Next item to run, foreground only.
+	volatile UI tail;		// Next free item, interrupts only.
+}WORKQ_RING_type;
+
+static WORKQ_RING_type workq[IRQ_PRIORITIES];
+static volatile UI workq_drops;
+
+
+/** @fn workq_post
+  @brief  Post deferred work.
+  @details Copies data into the ring of priority and returns, fn(ctx, data, len) runs later
+	   from the main loop. Meant for interrupt handlers, also works from the foreground.
+	   Interrupts are masked for the copy only, handlers of a higher priority may post
+	   into the same ring when nesting.
+  @warning
+  @param[in] unsigned char priority: IRQ_PRIORITY_LOWEST to IRQ_PRIORITY_HIGHEST, or
+	     WORKQ_PRIORITY_CURRENT for the priority of the handler posting.
+	     workq_fn fn, void *ctx, const void *data, unsigned char len: up to WORKQ_PAYLOAD, longer posts are rejected.
+  @param[Out] 1 when posted, 0 when the ring was full, fn is 0 or len is above WORKQ_PAYLOAD.
+*/
+UC workq_post(UC priority, workq_fn fn, void *ctx, const void *data, UC len) {
+
+	WORKQ_RING_type *q;
+	WORKQ_ITEM_type *it;
+	const UC *src = (const UC *)data;
+	UL mie;
+	UI tail;
+
+	if(priority == WORKQ_PRIORITY_CURRENT)
+		priority = irq_current_priority();
+	else if(priority > IRQ_PRIORITY_HIGHEST)
+		priority = IRQ_PRIORITY_HIGHEST;
+	q = &workq[priority];
+
+	mie = clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+	tail = q->tail;
+	if(tail - q->head >= WORKQ_DEPTH || fn == 0 || len > WORKQ_PAYLOAD)
+	{
+		workq_drops++;
+		if(mie)
+			set_csr(mstatus, MSTATUS_MIE);
+		return 0;
+	}
+	it = &q->item[tail & (WORKQ_DEPTH - 1)];
+	it->fn = fn;
+	it->ctx = ctx;
+	it->len = len;
+	for(UC i = 0; i < len; i++)
+		it->data[i] = src[i];
+	__asm__ __volatile__ ("fence" ::: "memory");	// Item before the index.
+	q->tail = tail + 1;
+	if(mie)
+		set_csr(mstatus, MSTATUS_MIE);
+	return 1;
+}
+
+
+/** @fn workq_run
+  @brief  Run the posted work.
+  @details Runs every item posted, highest priority first. Work posted while running is run
+	   too, an item of a higher priority before the next one of a lower priority.
+  @warning Call from the foreground only.
+  @param[in] No input parameter.
+  @param[Out] Number of items run.
+*/
+UI workq_run(void) {
+
+	WORKQ_RING_type *q;
+	WORKQ_ITEM_type *it;
+	UI head, count = 0;
+	int p;
+
+	while(1)
+	{
+		for(p = IRQ_PRIORITY_HIGHEST; p >= 0; p--)
+		{
+			q = &workq[p];
+			head = q->head;
+			if(head != q->tail)
+				break;
+		}
+		if(p < 0)
+			break;
+
+		__asm__ __volatile__ ("fence" ::: "memory");	// Index before the item.
+		it = &q->item[head & (WORKQ_DEPTH - 1)];
+		it->fn(it->ctx, it->data, it->len);		// Runs in place, the slot is free after.
+		__asm__ __volatile__ ("fence" ::: "memory");
+		q->head = head + 1;
+		count++;
+	}
+	return count;
+}
+
+
+/** @fn workq_idle
+  @brief  Idle hook of the main loop.
+  @details Waits in wfi until an interrupt when no work is posted, then runs the work. The
+	   check and wfi run with interrupts masked, so work posted in between still
+	   wakes the core.
+  @warning Call from the foreground with interrupts enabled.
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+void workq_idle(void) {
+
+	UL mie = clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+
+	if(!workq_pending())
+		__asm__ __volatile__ ("wfi");
+	if(mie)
+		set_csr(mstatus, MSTATUS_MIE);		// The waking interrupt runs here.
+	workq_run();
+}
+
+
+/** @fn workq_pending
+  @brief  Check for posted work.
+  @details
+  @warning
+  @param[in] No input parameter.
+  @param[Out] 1 when work is waiting.
+*/
+UC workq_pending(void) {
+
+	for(UC p = 0; p < IRQ_PRIORITIES; p++)
+	{
+		if(workq[p].head != workq[p].tail)
+			return 1;
+	}
+	return 0;
+}
+
+
+/** @fn workq_dropped
+  @brief  Posts lost to a full ring or rejected by workq_post.
+  @details
+  @warning
+  @param[in] No input parameter.
+  @param[Out] Number of dropped posts.
+*/
+UI workq_dropped(void) {
+
+	return workq_drops;
+}
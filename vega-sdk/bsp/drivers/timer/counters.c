@@ -0,0 +1,287 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  counters.c
+ * Brief Description of file             :  Hardware performance counters.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+
+#include <include/stdlib.h>
+#include <include/counters.h>
+#include <include/config.h>
+#include <include/encoding.h>
+
+
+static COUNTER_REGION_type regions[COUNTERS_REGIONS];
+static COUNTERS_type overhead;		// Counts of an empty start/stop pair.
+static UC hpm_kept;			// Bit n: hpm[n] has an event taken by the core.
+
+
+/** @fn counters_hpm
+  @brief  Read an event counter.
+  @details
+  @warning
+  @param[in] unsigned char n: counter, COUNTERS_HPM_FIRST to COUNTERS_HPM_FIRST + COUNTERS_HPM - 1.
+  @param[Out] Count, 0 for a counter not kept.
+*/
+ULL counters_hpm(UC n) {
+
+	switch(n)				// CSR numbers are immediates.
+	{
+	case 3: return COUNTERS_READ64(mhpmcounter3);
+	case 4: return COUNTERS_READ64(mhpmcounter4);
+	case 5: return COUNTERS_READ64(mhpmcounter5);
+	case 6: return COUNTERS_READ64(mhpmcounter6);
+	}
+	return 0;
+}
+
+
+/** @fn counters_set_event
+  @brief  Select the event of an event counter.
+  @details The selector is WARL: it is read back to tell whether the core counts the event.
+	   The counter is cleared. Counters 3 to COUNTERS_HPM_FIRST + COUNTERS_HPM - 1 are
+	   read by the regions from here on when the event is taken.
+  @warning Event numbers are core specific. Cores older than privileged spec 1.10 may not
+	   implement the CSRs at all and trap.
+  @param[in] unsigned char n: 3 to 6, unsigned long event
+  @param[Out] 1 when the core took the selector.
+*/
+UC counters_set_event(UC n, UL event) {
+
+	UL got;
+
+	switch(n)
+	{
+	case 3: write_csr(mhpmevent3, event); got = read_csr(mhpmevent3); write_csr(mhpmcounter3, 0); break;
+	case 4: write_csr(mhpmevent4, event); got = read_csr(mhpmevent4); write_csr(mhpmcounter4, 0); break;
+	case 5: write_csr(mhpmevent5, event); got = read_csr(mhpmevent5); write_csr(mhpmcounter5, 0); break;
+	case 6: write_csr(mhpmevent6, event); got = read_csr(mhpmevent6); write_csr(mhpmcounter6, 0); break;
+	default: return 0;
+	}
+	if(n - COUNTERS_HPM_FIRST < COUNTERS_HPM)
+	{
+		if(got == event)
+			hpm_kept |= 1 << (n - COUNTERS_HPM_FIRST);
+		else
+			hpm_kept &= ~(1 << (n - COUNTERS_HPM_FIRST));
+	}
+	return got == event;
+}
+
+
+/** @fn counters_read
+  @brief  Read all the counters kept.
+  @details cycles first and instret last, so that a region is charged the fewest cycles of
+	   the reads themselves. Event counters without an event set with counters_set_event
+	   are not read, they may trap, and count 0.
+  @warning
+  @param[in] COUNTERS_type *c
+  @param[Out] No output parameter.
+*/
+void counters_read(COUNTERS_type *c) {
+
+	c->cycles = counters_cycles();
+	for(UC i = 0; i < COUNTERS_HPM; i++)
+		c->hpm[i] = (hpm_kept & (1 << i)) ? counters_hpm(COUNTERS_HPM_FIRST + i) : 0;
+	c->instret = counters_instret();
+}
+
+
+/** @fn counters_init
+  @brief  Clear the regions and measure the cost of start and stop.
+  @details The smallest counts, field by field, of eight back to back counter reads are
+	   subtracted from every run.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+void counters_init(void) {
+
+	COUNTERS_type start, end, min;
+
+	counters_reset();
+	for(UC i = 0; i < 8; i++)
+	{
+		counters_read(&start);
+		counters_read(&end);
+		if(i == 0 || end.cycles - start.cycles < min.cycles)
+			min.cycles = end.cycles - start.cycles;
+		if(i == 0 || end.instret - start.instret < min.instret)
+			min.instret = end.instret - start.instret;
+		for(UC n = 0; n < COUNTERS_HPM; n++)
+			if(i == 0 || end.hpm[n] - start.hpm[n] < min.hpm[n])
+				min.hpm[n] = end.hpm[n] - start.hpm[n];
+	}
+	overhead = min;
+}
+
+
+/** @fn counters_region
+  @brief  Find or add a named region.
+  @details Regions are matched by name, names are kept by reference.
+  @warning
+  @param[in] const char *name
+  @param[Out] Region, -1 when all COUNTERS_REGIONS are taken.
+*/
+int counters_region(const char *name) {
+
+	int i;
+
+	for(i = 0; i < COUNTERS_REGIONS && regions[i].name; i++)
+	{
+		const char *a = regions[i].name, *b = name;
+
+		while(*a && *a == *b)
+		{
+			a++;
+			b++;
+		}
+		if(*a == *b)
+			return i;
+	}
+	if(i == COUNTERS_REGIONS)
+		return -1;
+	regions[i].name = name;
+	return i;
+}
+
+
+/** @fn counters_start
+  @brief  Start a run of a region.
+  @details
+  @warning Not reentrant, a region must not be started again from an interrupt.
+  @param[in] int region
+  @param[Out] No output parameter.
+*/
+void counters_start(int region) {
+
+	if((UI)region < COUNTERS_REGIONS)
+		counters_read(&regions[region].start);
+}
+
+
+/** @fn counters_stop
+  @brief  End a run of a region.
+  @details Adds the counts since counters_start, less the start/stop cost, to the region.
+  @warning
+  @param[in] int region
+  @param[Out] No output parameter.
+*/
+void counters_stop(int region) {
+
+	COUNTERS_type now;
+	COUNTER_REGION_type *r;
+
+	counters_read(&now);
+	if((UI)region >= COUNTERS_REGIONS)
+		return;
+	r = &regions[region];
+	r->total.cycles += now.cycles - r->start.cycles - overhead.cycles;
+	r->total.instret += now.instret - r->start.instret - overhead.instret;
+	for(UC i = 0; i < COUNTERS_HPM; i++)
+		r->total.hpm[i] += now.hpm[i] - r->start.hpm[i] - overhead.hpm[i];
+	r->runs++;
+}
+
+
+/** @fn counters_get
+  @brief  Counts of a region.
+  @details
+  @warning
+  @param[in] int region
+  @param[Out] Region, 0 for an invalid one.
+*/
+const COUNTER_REGION_type *counters_get(int region) {
+
+	if((UI)region >= COUNTERS_REGIONS)
+		return 0;
+	return &regions[region];
+}
+
+
+/** @fn counters_reset
+  @brief  Remove every region.
+  @details The start/stop cost measured by counters_init is kept.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+void counters_reset(void) {
+
+	UC *p = (UC *)regions;
+
+	for(UI i = 0; i < sizeof(regions); i++)
+		p[i] = 0;
+}
+
+
+/** @fn counters_print_ull
+  @brief  Print a 64 bit count in decimal.
+  @details printf takes no ll qualifier, so the count goes out in parts of nine digits.
+  @warning
+  @param[in] unsigned long long v
+  @param[Out] No output parameter.
+*/
+static void counters_print_ull(ULL v) {
+
+	if(v >= 1000000000)
+	{
+		counters_print_ull(v / 1000000000);
+		printf("%09u", (UI)(v % 1000000000));
+	}
+	else
+		printf("%u", (UI)v);
+}
+
+
+/** @fn counters_report
+  @brief  Print the regions as CSV over the debug UART.
+  @details One header line, then one line per region:
+	   counters,region,runs,cycles,instret,cpi,hpm3,... with cpi to three decimals.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+void counters_report(void) {
+
+	COUNTER_REGION_type *r;
+	ULL cpi;
+
+	printf("\n\rcounters,region,runs,cycles,instret,cpi");
+	for(UC i = 0; i < COUNTERS_HPM; i++)
+		printf(",hpm%d", COUNTERS_HPM_FIRST + i);
+
+	for(int n = 0; n < COUNTERS_REGIONS && regions[n].name; n++)
+	{
+		r = &regions[n];
+		cpi = r->total.instret ? r->total.cycles * 1000 / r->total.instret : 0;
+		printf("\n\rcounters,%s,%u,", r->name, r->runs);
+		counters_print_ull(r->total.cycles);
+		printf(",");
+		counters_print_ull(r->total.instret);
+		printf(",%u.%03u", (UI)(cpi / 1000), (UI)(cpi % 1000));
+		for(UC i = 0; i < COUNTERS_HPM; i++)
+		{
+			printf(",");
+			counters_print_ull(r->total.hpm[i]);
+		}
+	}
+	printf("\n\r");
+}
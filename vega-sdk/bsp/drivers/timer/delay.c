@@ -0,0 +1,190 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  delay.c
+ * Brief Description of file             :  Calibrated delay and sleep.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+#include <include/stdlib.h>
+#include <include/delay.h>
+#include <include/timer.h>
+#include <include/interrupt.h>
+#include <include/config.h>
+#include <include/encoding.h>
+#include <include/timebase.h>
+
+
+static struct
+{
+	UC timer_no;
+	UC sleep;			// Wake up timer available.
+}dly;
+
+
+/** @fn delay_timer_isr
+  @brief  Wake up timer interrupt.
+  @details Stops the timer, sleep_until checks the deadline itself.
+  @warning
+  @param[in] void *ctx: not used.
+  @param[Out] No output parameter.
+*/
+static void delay_timer_isr(void *ctx) {
+
+	Timer(dly.timer_no).Control = 0x0;		// One shot.
+}
+
+
+/** @fn delay_init
+  @brief  Calibrate the delays and set up sleeping.
+  @details Counts core cycles over DELAY_CAL_CLOCKS of timer_no, starting on a timer tick,
+	   and sets the time base conversions to the measured clock. The timer is then
+	   used to wake sleep_until. initialize_interrupt_table() must have been called
+	   before.
+  @warning Takes 10 ms. timer_no cannot be used for anything else afterwards.
+  @param[in] unsigned char timer_no
+  @param[Out] No output parameter.
+*/
+void delay_init(UC timer_no) {
+
+	UI t0, t1;
+	ULL c0, c1;
+
+	Timer(timer_no).Control = 0x0;			// Disable timer.
+	__asm__ __volatile__ ("fence");
+	Timer(timer_no).LoadCount = 0xFFFFFFFF;
+	__asm__ __volatile__ ("fence");
+	Timer(timer_no).Control = 0x07;			// Enable timer with intr masked.
+	__asm__ __volatile__ ("fence");
+
+	t0 = Timer(timer_no).CurrentValue;
+	while(Timer(timer_no).CurrentValue == t0)	// Start on a tick edge.
+		;
+	t0 = Timer(timer_no).CurrentValue;
+	c0 = time_now_cycles();
+	do {
+		t1 = Timer(timer_no).CurrentValue;
+		c1 = time_now_cycles();
+	} while(t0 - t1 < DELAY_CAL_CLOCKS);		// Counts down.
+
+	Timer(timer_no).Control = 0x0;
+	__asm__ __volatile__ ("fence");
+
+	time_set_core_hz((UL)(((c1 - c0) * TIMER_CLOCK_HZ) / (t0 - t1)));
+	dly.timer_no = timer_no;
+	dly.sleep = 1;
+
+	timer_set_callback(timer_no, delay_timer_isr, 0);
+	interrupt_enable(TIMER_IRQ(timer_no));
+}
+
+
+/** @fn delay_core_hz
+  @brief  Core clock used by the delays.
+  @details Measured by delay_init, CORE_CLOCK_HZ before.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] Core clock in Hz.
+*/
+UL delay_core_hz(void) {
+
+	return time_scale.core_hz;
+}
+
+
+/** @fn delay_cycles
+  @brief  Busy wait for a number of core cycles.
+  @details Independent of the compiler flags, the loop only reads the cycle counter.
+  @warning
+  @param[in] unsigned long long cycles
+  @param[Out] No output parameter.
+*/
+void delay_cycles(ULL cycles) {
+
+	ULL deadline = time_now_cycles() + cycles;
+
+	while(time_now_cycles() < deadline)
+		;
+}
+
+
+/** @fn sleep_until
+  @brief  Wait for a time base deadline.
+  @details Arms the wake up timer for the time left and waits in wfi. Interrupts are masked
+	   from arming the timer to wfi, so the wake up cannot be missed; wfi still returns
+	   on a pending interrupt and the interrupt is taken once they are unmasked. Other
+	   interrupts wake the core early and the timer is armed again. Without delay_init
+	   or for the last DELAY_SLEEP_MIN_US it spins.
+  @warning
+  @param[in] unsigned long long deadline: in cycles of time_now_cycles.
+  @param[Out] No output parameter.
+*/
+void sleep_until(ULL deadline) {
+
+	ULL now, left, clocks;
+	UL mie;
+	UI wEOI;
+
+	while((now = time_now_cycles()) < deadline)
+	{
+		left = deadline - now;
+		if(!dly.sleep || left < TIME_US2CYC(DELAY_SLEEP_MIN_US))
+			continue;
+
+		if(left > 0xFFFFFFFF)
+			left = 0xFFFFFFFF;			// Armed again on wake up.
+		clocks = left * TIMER_CLOCK_HZ / time_scale.core_hz;
+		if(clocks > 0xFFFFFFFF)
+			clocks = 0xFFFFFFFF;
+
+		mie = clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+		timer_run_in_intr_mode(dly.timer_no, (UI)clocks);
+		__asm__ __volatile__ ("wfi");
+		if(mie)
+			set_csr(mstatus, MSTATUS_MIE);		// delay_timer_isr runs here.
+		else if(Timer(dly.timer_no).IntrStatus)
+			wEOI = Timer(dly.timer_no).EOI;		// Not taken, clear the intr here.
+		Timer(dly.timer_no).Control = 0x0;		// Woken by another interrupt.
+	}
+}
+
+
+/** @fn delay_us
+  @brief  Wait for a number of microseconds.
+  @details Sleeps with sleep_until when set up by delay_init.
+  @warning
+  @param[in] unsigned int us
+  @param[Out] No output parameter.
+*/
+void delay_us(UI us) {
+
+	sleep_until(time_now_cycles() + time_us_to_cycles(us));
+}
+
+
+/** @fn delay_ms
+  @brief  Wait for a number of milliseconds.
+  @details Sleeps with sleep_until when set up by delay_init.
+  @warning
+  @param[in] unsigned int ms
+  @param[Out] No output parameter.
+*/
+void delay_ms(UI ms) {
+
+	sleep_until(time_now_cycles() + time_ms_to_cycles(ms));
+}
@@ -0,0 +1,223 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  longtimer.c
+ * Brief Description of file             :  64 bit timeouts on the hardware timers.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+
+#include <include/stdlib.h>
+#include <include/longtimer.h>
+#include <include/timer.h>
+#include <include/interrupt.h>
+#include <include/config.h>
+
+
+typedef struct
+{
+	ULL due;			// Clocks from the start of the running segment to expiry.
+	ULL period;			// 0 for a one shot timeout.
+	UI cur;				// Running segment.
+	UI next;			// Segment in LoadCount, runs after cur.
+	timer_callback fn;
+	void *ctx;
+	volatile UC active;
+}LONGTIMER_type;
+
+static LONGTIMER_type longtimer[TIMER_COUNT];
+
+
+/** @fn longtimer_segment
+  @brief  Length of the next segment.
+  @details Takes the longest segment, unless the rest would be shorter than
+	   LONGTIMER_MIN_CLOCKS, then halves what is left.
+  @warning
+  @param[in] unsigned long long left: clocks to expiry.
+  @param[Out] Segment length.
+*/
+static UI longtimer_segment(ULL left) {
+
+	if(left <= LONGTIMER_MAX_CLOCKS)
+		return (UI)left;
+	if(left - LONGTIMER_MAX_CLOCKS < LONGTIMER_MIN_CLOCKS)
+		return (UI)(left / 2);
+	return LONGTIMER_MAX_CLOCKS;
+}
+
+
+/** @fn longtimer_after
+  @brief  Segment to queue after the running one.
+  @details At expiry a periodic timeout continues with the first segment of the next period,
+	   a one shot timeout is stopped before the queued segment ends.
+  @warning
+  @param[in] LONGTIMER_type *lt
+  @param[Out] Segment length.
+*/
+static UI longtimer_after(LONGTIMER_type *lt) {
+
+	ULL left = lt->due - lt->cur;
+
+	if(left)
+		return longtimer_segment(left);
+	if(lt->period)
+		return longtimer_segment(lt->period);
+	return LONGTIMER_MAX_CLOCKS;
+}
+
+
+/** @fn longtimer_timer_isr
+  @brief  End of a segment.
+  @details The timer has already reloaded with the queued segment. At expiry the callback
+	   runs after the reload value for the segment after has been written.
+  @warning
+  @param[in] void *ctx: LONGTIMER_type of the timer.
+  @param[Out] No output parameter.
+*/
+static void longtimer_timer_isr(void *ctx) {
+
+	LONGTIMER_type *lt = (LONGTIMER_type *)ctx;
+	UC timer_no = (UC)(lt - longtimer);
+	UC expired;
+
+	lt->due -= lt->cur;
+	expired = (lt->due == 0);
+	if(expired)
+	{
+		if(lt->period == 0)
+		{
+			Timer(timer_no).Control = 0x0;	// Disable timer.
+			lt->active = 0;
+			if(lt->fn)
+				lt->fn(lt->ctx);
+			return;
+		}
+		lt->due = lt->period;
+	}
+
+	lt->cur = lt->next;
+	lt->next = longtimer_after(lt);
+	Timer(timer_no).LoadCount = lt->next;
+
+	if(expired && lt->fn)
+		lt->fn(lt->ctx);
+}
+
+
+/** @fn longtimer_start
+  @brief  Start a 64 bit timeout.
+  @details fn is called with ctx from the timer interrupt after clocks timer clocks, then
+	   every period clocks if period is not 0. Periods are counted from the previous
+	   expiry, not from the callback, so they do not drift. A running timeout on the
+	   timer is replaced. initialize_interrupt_table() must have been called before.
+  @warning clocks and period are raised to LONGTIMER_MIN_CLOCKS.
+  @param[in] unsigned char timer_no, unsigned long long clocks, unsigned long long period,
+	     timer_callback fn, void *ctx
+  @param[Out] No output parameter.
+*/
+void longtimer_start(UC timer_no, ULL clocks, ULL period, timer_callback fn, void *ctx) {
+
+	LONGTIMER_type *lt = &longtimer[timer_no];
+
+	interrupt_disable(TIMER_IRQ(timer_no));
+	Timer(timer_no).Control = 0x0;			// Disable timer.
+	__asm__ __volatile__ ("fence");
+
+	if(clocks < LONGTIMER_MIN_CLOCKS)
+		clocks = LONGTIMER_MIN_CLOCKS;
+	if(period && period < LONGTIMER_MIN_CLOCKS)
+		period = LONGTIMER_MIN_CLOCKS;
+
+	lt->due = clocks;
+	lt->period = period;
+	lt->fn = fn;
+	lt->ctx = ctx;
+	lt->cur = longtimer_segment(clocks);
+	lt->next = longtimer_after(lt);
+	lt->active = 1;
+	timer_set_callback(timer_no, longtimer_timer_isr, lt);
+
+	timer_run_in_intr_mode(timer_no, lt->cur);
+	(void)Timer(timer_no).CurrentValue;		// Counter has loaded.
+	Timer(timer_no).LoadCount = lt->next;		// Reload for the segment after.
+	interrupt_enable(TIMER_IRQ(timer_no));
+}
+
+
+/** @fn longtimer_stop
+  @brief  Stop a timeout.
+  @details The callback is not called.
+  @warning
+  @param[in] unsigned char timer_no
+  @param[Out] No output parameter.
+*/
+void longtimer_stop(UC timer_no) {
+
+	Timer(timer_no).Control = 0x0;			// Disable timer.
+	__asm__ __volatile__ ("fence");
+	longtimer[timer_no].active = 0;
+}
+
+
+/** @fn longtimer_active
+  @brief  Check for a running timeout.
+  @details A one shot timeout stops being active when it expires.
+  @warning
+  @param[in] unsigned char timer_no
+  @param[Out] 1 while the timeout runs.
+*/
+UC longtimer_active(UC timer_no) {
+
+	return longtimer[timer_no].active;
+}
+
+
+/** @fn longtimer_remaining
+  @brief  Timer clocks to the next expiry.
+  @details A segment that has ended while its interrupt is pending is accounted for, so the
+	   result is exact to the timer clock.
+  @warning
+  @param[in] unsigned char timer_no
+  @param[Out] Clocks left, 0 when not active.
+*/
+ULL longtimer_remaining(UC timer_no) {
+
+	LONGTIMER_type *lt = &longtimer[timer_no];
+	ULL left;
+	UI value;
+
+	if(!lt->active)
+		return 0;
+
+	interrupt_disable(TIMER_IRQ(timer_no));
+	value = Timer(timer_no).CurrentValue;
+	if(Timer(timer_no).IntrStatus)			// Read after the value, cur had ended.
+	{
+		value = Timer(timer_no).CurrentValue;	// Running the queued segment.
+		left = lt->due - lt->cur;
+		if(left == 0)
+			left = lt->period;
+		if(left)
+			left -= lt->next - value;
+	}
+	else
+		left = lt->due - (lt->cur - value);
+	interrupt_enable(TIMER_IRQ(timer_no));
+
+	return left;
+}
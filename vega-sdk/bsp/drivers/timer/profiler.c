@@ -0,0 +1,197 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  profiler.c
+ * Brief Description of file             :  PC sampling profiler.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+
+#include <include/stdlib.h>
+#include <include/profiler.h>
+#include <include/timer.h>
+#include <include/interrupt.h>
+#include <include/config.h>
+#include <include/encoding.h>
+#include <include/debug_uart.h>
+
+extern char _start[], _end[];		// Program image, from the linker script.
+
+static struct
+{
+	UL base;
+	UC shift;
+	UC timer_no;
+	UI period;
+	UI lfsr;
+	volatile UI samples;
+	volatile UI outside;		// Samples out of the image.
+	UI bucket[PROFILER_BUCKETS];
+}prof;
+
+
+/** @fn profiler_timer_isr
+  @brief  Take one sample.
+  @details mepc is the address the running code was interrupted at, or within a handler of
+	   lower priority when nesting. The reload value for the next period gets a new
+	   jitter.
+  @warning
+  @param[in] void *ctx: not used.
+  @param[Out] No output parameter.
+*/
+static void profiler_timer_isr(void *ctx) {
+
+	UL index = (read_csr(mepc) - prof.base) >> prof.shift;
+
+	if(index < PROFILER_BUCKETS)
+		prof.bucket[index]++;
+	else
+		prof.outside++;
+	prof.samples++;
+
+	prof.lfsr = (prof.lfsr >> 1) ^ (-(prof.lfsr & 1) & 0xD0000001U);	// Galois LFSR.
+	Timer(prof.timer_no).LoadCount = prof.period + (prof.lfsr & PROFILER_JITTER_MASK);
+}
+
+
+/** @fn profiler_reset
+  @brief  Clear the histogram.
+  @details
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+void profiler_reset(void) {
+
+	UL mie = clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+
+	for(UI i = 0; i < PROFILER_BUCKETS; i++)
+		prof.bucket[i] = 0;
+	prof.samples = 0;
+	prof.outside = 0;
+	if(mie)
+		set_csr(mstatus, MSTATUS_MIE);
+}
+
+
+/** @fn profiler_start
+  @brief  Start sampling.
+  @details Samples every period_clocks timer clocks, plus jitter, from the interrupt of
+	   timer_no at the highest priority, so handlers are sampled too when nesting. The
+	   histogram is kept from earlier runs, see profiler_reset().
+	   initialize_interrupt_table() must have been called before.
+  @warning timer_no cannot be used for anything else while sampling.
+  @param[in] unsigned char timer_no, unsigned int period_clocks
+  @param[Out] No output parameter.
+*/
+void profiler_start(UC timer_no, UI period_clocks) {
+
+	UL size = (UL)(_end - _start);
+
+	prof.base = (UL)_start;
+	prof.shift = 2;					// Instructions are 4 bytes.
+	while((size >> prof.shift) >= PROFILER_BUCKETS)
+		prof.shift++;
+
+	prof.timer_no = timer_no;
+	prof.period = period_clocks;
+	if(prof.lfsr == 0)
+		prof.lfsr = 0xACE1;
+
+	timer_set_callback(timer_no, profiler_timer_isr, 0);
+	irq_set_priority(TIMER_IRQ(timer_no), IRQ_PRIORITY_HIGHEST);
+	timer_run_in_intr_mode(timer_no, period_clocks);
+	interrupt_enable(TIMER_IRQ(timer_no));
+}
+
+
+/** @fn profiler_stop
+  @brief  Stop sampling.
+  @details The histogram is kept for profiler_dump.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+void profiler_stop(void) {
+
+	interrupt_disable(TIMER_IRQ(prof.timer_no));
+	Timer(prof.timer_no).Control = 0x0;		// Disable timer.
+	__asm__ __volatile__ ("fence");
+}
+
+
+/** @fn profiler_samples
+  @brief  Number of samples taken.
+  @details
+  @warning
+  @param[in] No input parameter.
+  @param[Out] Samples since the last reset.
+*/
+UI profiler_samples(void) {
+
+	return prof.samples;
+}
+
+
+/** @fn profiler_tx
+  @brief  Send a little endian value over the debug UART.
+  @details
+  @warning
+  @param[in] unsigned int value, unsigned char bytes
+  @param[Out] No output parameter.
+*/
+static void profiler_tx(UI value, UC bytes) {
+
+	while(bytes--)
+	{
+		tx_uart((UC)value);
+		value >>= 8;
+	}
+}
+
+
+/** @fn profiler_dump
+  @brief  Send the histogram over the debug UART.
+  @details Binary, in the format described in profiler.h. Only non empty buckets are sent.
+	   Sampling may go on, counts taken during the dump may or may not be included.
+  @warning Nothing else should print during the dump.
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+void profiler_dump(void) {
+
+	const char *magic = "VPRF";
+
+	for(UC i = 0; i < 4; i++)
+		tx_uart(magic[i]);
+	profiler_tx((UI)prof.base, 4);
+	profiler_tx(prof.shift, 1);
+	profiler_tx(0, 1);
+	profiler_tx(PROFILER_BUCKETS, 2);
+	profiler_tx(prof.samples, 4);
+	profiler_tx(prof.outside, 4);
+
+	for(UI i = 0; i < PROFILER_BUCKETS; i++)
+	{
+		if(prof.bucket[i] == 0)
+			continue;
+		profiler_tx(i, 2);
+		profiler_tx(prof.bucket[i], 4);
+	}
+	profiler_tx(PROFILER_END, 2);
+}
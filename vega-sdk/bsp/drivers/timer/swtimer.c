@@ -0,0 +1,447 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  swtimer.c
+ * Brief Description of file             :  Hierarchical software timer wheel.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+#include <include/stdlib.h>
+#include <include/swtimer.h>
+#include <include/timer.h>
+#include <include/interrupt.h>
+#include <include/config.h>
+#include <include/timebase.h>
+
+
+#define SWTIMER_BITS		6
+#define SWTIMER_MASK		(SWTIMER_SLOTS - 1)
+#define SWTIMER_SPAN(level)	(1ULL << (SWTIMER_BITS * (level)))	// Ticks covered by one slot.
+#define SWTIMER_MAX_DELTA	(SWTIMER_SPAN(SWTIMER_LEVELS) - 1)
+#define SWTIMER_STOPPED		(~0ULL)
+
+// Core cycles to timer clocks.
+#define SWTIMER_CYC2CLK(c)	((TIMER_CLOCK_HZ == CORE_CLOCK_HZ) ? (c) : (c) * TIMER_CLOCK_HZ / CORE_CLOCK_HZ)
+
+static struct
+{
+	SWTIMER_type *slot[SWTIMER_LEVELS][SWTIMER_SLOTS];
+	ULL occupied[SWTIMER_LEVELS];	// Non empty slots, one bit each.
+	ULL now;			// Last processed tick.
+	ULL armed;			// Tick the hardware timer is set for.
+	SWTIMER_type *deferred_head;
+	SWTIMER_type *deferred_tail;
+	UC timer_no;
+}wheel;
+
+
+/** @fn swtimer_lock
+  @brief  Keep the wheel interrupt out.
+  @details Only the interrupt of the wheel timer is masked.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+static inline void swtimer_lock(void) {
+
+	interrupt_disable(TIMER_IRQ(wheel.timer_no));
+}
+
+
+/** @fn swtimer_unlock
+  @brief  Let the wheel interrupt in again.
+  @details
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+static inline void swtimer_unlock(void) {
+
+	interrupt_enable(TIMER_IRQ(wheel.timer_no));
+}
+
+
+/** @fn swtimer_insert
+  @brief  Put a timer in its slot.
+  @details The level is chosen by the ticks left: level n holds timers due in less than
+	   64^(n+1) ticks, in the slot given by bits 6n..6n+5 of the expiry tick. Timers
+	   further away than the top level wait in its last slot and are placed again
+	   when it is cascaded.
+  @warning
+  @param[in] timer
+  @param[Out] No output parameter.
+*/
+static void swtimer_insert(SWTIMER_type *t) {
+
+	ULL at = t->expires;
+	ULL delta = at - wheel.now;
+	UC level = 0;
+	UC slot;
+
+	if(delta > SWTIMER_MAX_DELTA)
+		at = wheel.now + SWTIMER_MAX_DELTA;
+	while(level < SWTIMER_LEVELS - 1 && delta >= SWTIMER_SPAN(level + 1))
+		level++;
+	slot = (at >> (SWTIMER_BITS * level)) & SWTIMER_MASK;
+
+	t->level = level;
+	t->slot = slot;
+	t->next = wheel.slot[level][slot];
+	if(t->next)
+		t->next->pprev = &t->next;
+	wheel.slot[level][slot] = t;
+	t->pprev = &wheel.slot[level][slot];
+	wheel.occupied[level] |= 1ULL << slot;
+}
+
+
+/** @fn swtimer_unlink
+  @brief  Take a pending timer out of its slot.
+  @details O(1), the timer points at the link pointing at it.
+  @warning
+  @param[in] timer
+  @param[Out] No output parameter.
+*/
+static void swtimer_unlink(SWTIMER_type *t) {
+
+	*t->pprev = t->next;
+	if(t->next)
+		t->next->pprev = t->pprev;
+	if(wheel.slot[t->level][t->slot] == 0)
+		wheel.occupied[t->level] &= ~(1ULL << t->slot);
+	t->pprev = 0;
+}
+
+
+/** @fn swtimer_next_tick
+  @brief  Next tick with work to do.
+  @details For every level the first occupied slot after the current one is found in
+	   the bitmap. A level 0 slot is due at its tick, a higher slot at the tick where
+	   it is cascaded. Slots at or before the current one belong to the next turn of
+	   the level.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] Tick, SWTIMER_STOPPED if no timer is pending.
+*/
+static ULL swtimer_next_tick(void) {
+
+	ULL next = SWTIMER_STOPPED;
+
+	for(UC level = 0; level < SWTIMER_LEVELS; level++)
+	{
+		ULL map = wheel.occupied[level];
+		UC shift = SWTIMER_BITS * level;
+		UC cur;
+		ULL base, after, tick;
+
+		if(map == 0)
+			continue;
+		cur = (wheel.now >> shift) & SWTIMER_MASK;
+		base = (wheel.now >> (shift + SWTIMER_BITS)) << (shift + SWTIMER_BITS);
+		after = (cur == SWTIMER_MASK) ? 0 : map & (~0ULL << (cur + 1));
+		if(after)
+			tick = base + ((ULL)__builtin_ctzll(after) << shift);
+		else
+			tick = base + SWTIMER_SPAN(level + 1) + ((ULL)__builtin_ctzll(map) << shift);
+		if(tick < next)
+			next = tick;
+	}
+	return next;
+}
+
+
+/** @fn swtimer_fire
+  @brief  Run or queue the callback of an expired timer.
+  @details
+  @warning
+  @param[in] timer
+  @param[Out] No output parameter.
+*/
+static void swtimer_fire(SWTIMER_type *t) {
+
+	if(!(t->flags & SWTIMER_DEFERRED))
+	{
+		t->fn(t->ctx);
+		return;
+	}
+	t->run = 1;
+	if(t->queued)
+		return;
+	t->queued = 1;
+	t->deferred_next = 0;
+	if(wheel.deferred_tail)
+		wheel.deferred_tail->deferred_next = t;
+	else
+		wheel.deferred_head = t;
+	wheel.deferred_tail = t;
+}
+
+
+/** @fn swtimer_advance
+  @brief  Process the wheel up to a tick.
+  @details Jumps from one tick with work to the next. At each one the slots of the levels
+	   that wrap are cascaded, lowest level first, then the level 0 slot expires.
+	   Periodic timers are placed again before their callback, so the callback may
+	   cancel them.
+  @warning
+  @param[in] unsigned long long tick
+  @param[Out] No output parameter.
+*/
+static void swtimer_advance(ULL tick) {
+
+	ULL next;
+	SWTIMER_type *t;
+
+	while((next = swtimer_next_tick()) <= tick)
+	{
+		wheel.now = next;
+		for(UC level = 1; level < SWTIMER_LEVELS; level++)
+		{
+			UC slot = (next >> (SWTIMER_BITS * level)) & SWTIMER_MASK;
+
+			if(next & (SWTIMER_SPAN(level) - 1))
+				break;
+			t = wheel.slot[level][slot];
+			wheel.slot[level][slot] = 0;
+			wheel.occupied[level] &= ~(1ULL << slot);
+			while(t)
+			{
+				SWTIMER_type *following = t->next;
+
+				swtimer_insert(t);
+				t = following;
+			}
+		}
+
+		while((t = wheel.slot[0][next & SWTIMER_MASK]) != 0)
+		{
+			swtimer_unlink(t);
+			if(t->period)
+			{
+				t->expires += t->period;
+				swtimer_insert(t);
+			}
+			swtimer_fire(t);
+		}
+	}
+	if(tick > wheel.now)
+		wheel.now = tick;		// Every tick in between is empty.
+}
+
+
+/** @fn swtimer_arm
+  @brief  Program the hardware timer for the next tick with work.
+  @details Stops it when no timer is pending. Waits longer than the timer can count end
+	   early and are armed again.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] No output parameter.
+*/
+static void swtimer_arm(void) {
+
+	ULL next = swtimer_next_tick();
+	ULL now, at, clocks;
+
+	wheel.armed = next;
+	if(next == SWTIMER_STOPPED)
+	{
+		Timer(wheel.timer_no).Control = 0x0;	// Disable timer.
+		__asm__ __volatile__ ("fence");
+		return;
+	}
+
+	now = time_now_cycles();
+	at = next * SWTIMER_TICK_CYCLES;
+	clocks = SWTIMER_CYC2CLK((at > now) ? at - now : 0) + 1;	// Never early by rounding.
+	if(clocks > 0xFFFFFFFF)
+		clocks = 0xFFFFFFFF;
+	timer_run_in_intr_mode(wheel.timer_no, (UI)clocks);
+}
+
+
+/** @fn swtimer_timer_isr
+  @brief  Wheel timer interrupt.
+  @details Processes every tick up to now and programs the timer for the next one.
+  @warning
+  @param[in] void *ctx: not used.
+  @param[Out] No output parameter.
+*/
+static void swtimer_timer_isr(void *ctx) {
+
+	swtimer_advance(time_now_cycles() / SWTIMER_TICK_CYCLES);
+	swtimer_arm();
+}
+
+
+/** @fn swtimer_init
+  @brief  Initialise the software timers.
+  @details The wheel runs from the interrupt of timer_no, which stays stopped while no
+	   timer is pending. initialize_interrupt_table() must have been called before.
+  @warning timer_no cannot be used for anything else afterwards.
+  @param[in] unsigned char timer_no
+  @param[Out] No output parameter.
+*/
+void swtimer_init(UC timer_no) {
+
+	Timer(timer_no).Control = 0x0;		// Disable timer.
+	__asm__ __volatile__ ("fence");
+
+	for(UC level = 0; level < SWTIMER_LEVELS; level++)
+	{
+		for(UC slot = 0; slot < SWTIMER_SLOTS; slot++)
+			wheel.slot[level][slot] = 0;
+		wheel.occupied[level] = 0;
+	}
+	wheel.now = time_now_cycles() / SWTIMER_TICK_CYCLES;
+	wheel.armed = SWTIMER_STOPPED;
+	wheel.deferred_head = wheel.deferred_tail = 0;
+	wheel.timer_no = timer_no;
+
+	timer_set_callback(timer_no, swtimer_timer_isr, 0);
+	interrupt_enable(TIMER_IRQ(timer_no));
+}
+
+
+/** @fn swtimer_setup
+  @brief  Prepare a timer.
+  @details The timer structure belongs to the caller and must stay valid while pending.
+  @warning
+  @param[in] timer, callback, void *ctx: callback argument, unsigned char flags: 0 or SWTIMER_DEFERRED.
+  @param[Out] No output parameter.
+*/
+void swtimer_setup(SWTIMER_type *t, swtimer_fn fn, void *ctx, UC flags) {
+
+	t->pprev = 0;
+	t->fn = fn;
+	t->ctx = ctx;
+	t->flags = flags;
+	t->queued = 0;
+	t->run = 0;
+}
+
+
+/** @fn swtimer_start
+  @brief  Start or restart a timer.
+  @details O(1). A pending timer is moved to its new expiry. The hardware timer is only
+	   programmed again if this timer is due before the tick it is set for. Can be
+	   called from a callback.
+  @warning
+  @param[in] timer, unsigned int delay_ticks: first expiry, unsigned int period_ticks: 0 for one shot.
+  @param[Out] No output parameter.
+*/
+void swtimer_start(SWTIMER_type *t, UI delay_ticks, UI period_ticks) {
+
+	ULL now = time_now_cycles() / SWTIMER_TICK_CYCLES;
+
+	swtimer_lock();
+	if(t->pprev)
+		swtimer_unlink(t);
+	t->run = 0;
+	if(now < wheel.now)
+		now = wheel.now;
+	t->expires = now + (delay_ticks ? delay_ticks : 1);
+	t->period = period_ticks;
+	swtimer_insert(t);
+	if(t->expires < wheel.armed)
+		swtimer_arm();
+	swtimer_unlock();
+}
+
+
+/** @fn swtimer_cancel
+  @brief  Stop a timer.
+  @details O(1). A deferred callback that has not run yet is dropped as well. The hardware
+	   timer is left as it is, an early interrupt finds nothing to do.
+  @warning
+  @param[in] timer
+  @param[Out] No output parameter.
+*/
+void swtimer_cancel(SWTIMER_type *t) {
+
+	swtimer_lock();
+	if(t->pprev)
+		swtimer_unlink(t);
+	t->run = 0;
+	swtimer_unlock();
+}
+
+
+/** @fn swtimer_pending
+  @brief  Whether a timer is waiting to expire.
+  @details
+  @warning
+  @param[in] timer
+  @param[Out] 1 if pending, 0 otherwise.
+*/
+UC swtimer_pending(SWTIMER_type *t) {
+
+	return t->pprev != 0;
+}
+
+
+/** @fn swtimer_run_deferred
+  @brief  Run the callbacks of expired SWTIMER_DEFERRED timers.
+  @details Call from the main loop. Callbacks run in expiry order with interrupts enabled.
+	   A timer that expired several times since the last call runs once.
+  @warning
+  @param[in] No input parameter.
+  @param[Out] Number of callbacks run.
+*/
+UI swtimer_run_deferred(void) {
+
+	SWTIMER_type *t;
+	UI count = 0;
+	UC run;
+
+	while(1)
+	{
+		swtimer_lock();
+		t = wheel.deferred_head;
+		if(t)
+		{
+			wheel.deferred_head = t->deferred_next;
+			if(wheel.deferred_head == 0)
+				wheel.deferred_tail = 0;
+			t->queued = 0;
+			run = t->run;
+			t->run = 0;
+		}
+		swtimer_unlock();
+
+		if(t == 0)
+			return count;
+		if(run)
+		{
+			t->fn(t->ctx);
+			count++;
+		}
+	}
+}
+
+
+/** @fn swtimer_now
+  @brief  Current tick.
+  @details
+  @warning
+  @param[in] No input parameter.
+  @param[Out] Ticks of SWTIMER_TICK_US.
+*/
+ULL swtimer_now(void) {
+
+	return time_now_cycles() / SWTIMER_TICK_CYCLES;
+}
@@ -0,0 +1,57 @@
+/***************************************************************************
+ * Project                               :  MDP
+ * Name of the file                      :  timebase.c
+ * Brief Description of file             :  64 bit time base conversion factors.
+
+  Copyright (C) 2020  CDAC(T). All rights reserved.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+***************************************************************************/
+
+
+#include <include/stdlib.h>
+#include <include/timebase.h>
+#include <include/config.h>
+
+
+TIME_SCALE_type time_scale = {
+	CORE_CLOCK_HZ,
+	TIME_SCALE_Q32(1000000000ULL, CORE_CLOCK_HZ),
+	TIME_SCALE_Q32(1000000ULL, CORE_CLOCK_HZ),
+	TIME_SCALE_Q32(1000ULL, CORE_CLOCK_HZ),
+	TIME_SCALE_Q32(CORE_CLOCK_HZ, 1000000000ULL),
+	TIME_SCALE_Q32(CORE_CLOCK_HZ, 1000000ULL),
+	TIME_SCALE_Q32(CORE_CLOCK_HZ, 1000ULL)
+};
+
+
+/** @fn time_set_core_hz
+  @brief  Set the core clock used by the conversions.
+  @details Called by delay_init with the measured clock. The divisions run once here,
+	   the conversions only multiply.
+  @warning
+  @param[in] unsigned long core_hz
+  @param[Out] No output parameter.
+*/
+void time_set_core_hz(UL core_hz) {
+
+	time_scale.cyc2ns = TIME_SCALE_Q32(1000000000ULL, core_hz);
+	time_scale.cyc2us = TIME_SCALE_Q32(1000000ULL, core_hz);
+	time_scale.cyc2ms = TIME_SCALE_Q32(1000ULL, core_hz);
+	time_scale.ns2cyc = TIME_SCALE_Q32(core_hz, 1000000000ULL);
+	time_scale.us2cyc = TIME_SCALE_Q32(core_hz, 1000000ULL);
+	time_scale.ms2cyc = TIME_SCALE_Q32(core_hz, 1000ULL);
+	time_scale.core_hz = core_hz;
+}
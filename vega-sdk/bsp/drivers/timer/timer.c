@@ -29,6 +29,12 @@
 #include <include/config.h>
 
 
+static struct
+{
+	timer_callback fn;
+	void *ctx;
+}timer_cb[TIMER_COUNT];
+
 
 
 /** @fn timer_put_delay
@@ -99,51 +105,94 @@ void timer_run_in_intr_mode(UC timer_no, UI no_of_clocks) {
 }
 
 
+/** @fn timer_set_callback
+  @brief  Register the interrupt callback of a timer.
+  @details fn is called with ctx from the timer interrupt after the interrupt has been
+	   acknowledged. A null fn only acknowledges the interrupt. The interrupt line is
+	   not enabled here, see interrupt_enable(). The callback is cleared while ctx is
+	   changed, so it can be replaced with the interrupt running.
+  @warning
+  @param[in] unsigned char timer_no, timer_callback fn, void *ctx
+  @param[Out] No output parameter.
+*/
+void timer_set_callback(UC timer_no, timer_callback fn, void *ctx) {
+
+	timer_cb[timer_no].fn = 0;
+	__asm__ __volatile__ ("fence" ::: "memory");
+	timer_cb[timer_no].ctx = ctx;
+	__asm__ __volatile__ ("fence" ::: "memory");
+	timer_cb[timer_no].fn = fn;
+}
+
+
+/** @fn timer_dispatch
+  @brief  Common part of the timer interrupt handlers.
+  @details Reads the EOI register to clear the intr and calls the callback, if any.
+  @warning
+  @param[in] unsigned char timer_no
+  @param[Out] No output parameter.
+*/
+static inline void timer_dispatch(UC timer_no) {
+
+	UI wEOI;
+	timer_callback fn;
+
+	wEOI = Timer(timer_no).EOI;			// Reads the EOI register to clear the intr.
+	fn = timer_cb[timer_no].fn;
+	if(fn)
+		fn(timer_cb[timer_no].ctx);
+}
+
+
+/** @fn timer_intr_handler
+  @brief  Shared timer intr handler.
+  @details Registered for the three timers by initialize_interrupt_table.
+  @warning 
+  @param[in] void *ctx: timer number.
+  @param[Out] No output parameter.
+*/
+void timer_intr_handler(void *ctx) {
+
+	timer_dispatch((UC)(UL)ctx);
+}
+
+
 /** @fn timer0_intr_handler
   @brief  timer 0 intr handler.
-  @details The function will execute the steps as described in routine
+  @details Acknowledges the interrupt and calls the timer 0 callback.
   @warning 
-  @param[in] unsigned char, unsigned int
+  @param[in] No input parameter.
   @param[Out] No output parameter.
 */
 void timer0_intr_handler(void) {
-	UI wEOI;
-	wEOI = Timer(0).EOI;			// Reads the Timer 0 EOI register to clear the intr.
-	// User can add their code for TImer 0 interrupt.
-	printf("\n\r TIMER 0 EXT intr occurred");
-	return;   
+
+	timer_dispatch(0);
 }
 
 
 /** @fn timer1_intr_handler
   @brief  timer 1 intr handler.
-  @details The function will execute the steps as described in routine
+  @details Acknowledges the interrupt and calls the timer 1 callback.
   @warning 
-  @param[in] unsigned char, unsigned int
+  @param[in] No input parameter.
   @param[Out] No output parameter.
 */
 void timer1_intr_handler(void) {
-	UI wEOI;
-	wEOI = Timer(1).EOI;			// Reads the Timer 1 EOI register to clear the intr.
-	// User can add their code for TImer 1 interrupt.
-	printf("\n\r TIMER 1 EXT intr occurred");
-	return;   
+
+	timer_dispatch(1);
 }
 
 
 /** @fn timer2_intr_handler
   @brief  timer 2 intr handler.
-  @details The function will execute the steps as described in routine
+  @details Acknowledges the interrupt and calls the timer 2 callback.
   @warning 
-  @param[in] unsigned char, unsigned int
+  @param[in] No input parameter.
   @param[Out] No output parameter.
 */
 void timer2_intr_handler(void) {
-	UI wEOI;
-	wEOI = Timer(2).EOI;			// Reads the Timer 2 EOI register to clear the intr.
-	// User can add their code for TImer 2 interrupt.
-	printf("\n\r TIMER 2 EXT intr occurred");
-	return;   
+
+	timer_dispatch(2);
 }
 
 
@@ -0,0 +1,92 @@
+#ifndef BITBANG_H_
+#define BITBANG_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for CORE_CLOCK_HZ
+#include "encoding.h"	//for mstatus
+#include "timebase.h"	//for the cycle counter
+
+/*  Defines section
+*
+*   Cycle accurate bit-bang engine. Waveforms are given as edge schedules in
+*   core cycles from the start of the frame (see TIME_NS2CYC). Every edge is
+*   written at its cycle deadline rather than after a delay, so the time spent
+*   between edges does not add up. Interrupts are masked from the first to
+*   the last edge of a frame only.
+***************************************************/
+
+#define BITBANG_LEAD_CYCLES	64	// First edge of a frame, after the setup.
+
+typedef struct
+{
+	UI at;				// Core cycles from the start of the frame.
+	UC level;			// HIGH or LOW.
+}BITBANG_EDGE_type;
+
+typedef struct
+{
+	UI t0h;				// High time of a 0 bit, in core cycles.
+	UI t1h;				// High time of a 1 bit.
+	UI period;			// Bit period.
+}BITBANG_SYMBOL_type;
+
+
+/*  Function definitions
+*
+***************************************************/
+
+/** @fn bitbang_frame_begin
+ * @brief  Mask interrupts for a frame.
+ * @details
+ * @warning Keep frames short, interrupts are held off until bitbang_frame_end.
+ * @param[in] No input parameter.
+ * @param[Out] Previous interrupt enable, for bitbang_frame_end.
+*/
+static inline __attribute__((always_inline)) UL bitbang_frame_begin(void) {
+
+	return clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+}
+
+/** @fn bitbang_frame_end
+ * @brief  Restore the interrupt enable saved by bitbang_frame_begin.
+ * @details
+ * @warning
+ * @param[in] unsigned long mie
+ * @param[Out] No output parameter.
+*/
+static inline __attribute__((always_inline)) void bitbang_frame_end(UL mie) {
+
+	if(mie)
+		set_csr(mstatus, MSTATUS_MIE);
+}
+
+/** @fn bitbang_wait_until
+ * @brief  Busy wait for a deadline in the low word of the time base.
+ * @details One CSR read per poll. The signed difference keeps working when the low
+ *	    word wraps.
+ * @warning The deadline must be less than 2^31 cycles ahead.
+ * @param[in] unsigned long deadline: from time_now_cycles32.
+ * @param[Out] No output parameter.
+*/
+static inline __attribute__((always_inline)) void bitbang_wait_until(UL deadline) {
+
+	while((long)(time_now_cycles32() - deadline) < 0)
+		;
+}
+
+
+/*  Function declarations
+*
+***************************************************/
+
+void bitbang_run(US pin_no, const BITBANG_EDGE_type *edge, UI count);
+void bitbang_symbols(US pin_no, const UC *data, UI bits, const BITBANG_SYMBOL_type *symbol);
+
+
+#endif /* BITBANG_H_ */
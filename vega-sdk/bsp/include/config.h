@@ -23,6 +23,14 @@
 #define GPIO_1_BASE_ADDRESS			0x10180000UL
 #define TIMER_BASE_ADDRESS 			0x10000A00UL
 
+#ifndef CORE_CLOCK_HZ
+#define CORE_CLOCK_HZ				40000000UL	// Core clock, mcycle counts at this rate.
+#endif
+
+#ifndef TIMER_CLOCK_HZ
+#define TIMER_CLOCK_HZ				CORE_CLOCK_HZ	// Clock of the hardware timers.
+#endif
+
 
 #define CONCATENATE(X) #X
 #define CONCAT(X) CONCATENATE(X)
@@ -0,0 +1,98 @@
+#ifndef COUNTERS_H_
+#define COUNTERS_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for datatypes
+#include "encoding.h"	//for read_csr
+
+/*  Defines section
+*
+*   Hardware performance counters: mcycle, minstret and the first
+*   COUNTERS_HPM event counters from mhpmcounter3. Counts are 64 bit, read
+*   high, low, high on 32 bit processors. Named regions accumulate the
+*   counts between counters_start and counters_stop, less the cost of the
+*   two calls, and counters_report prints them as CSV over the debug UART.
+*   Event selectors are core specific. An event counter is only read once
+*   counters_set_event has given it an event the core takes, so cores
+*   without event counters do not trap; the others count 0.
+***************************************************/
+
+#ifndef COUNTERS_REGIONS
+#define COUNTERS_REGIONS	8
+#endif
+#ifndef COUNTERS_HPM
+#define COUNTERS_HPM		2	// mhpmcounter3 and mhpmcounter4.
+#endif
+#define COUNTERS_HPM_FIRST	3
+
+#if __riscv_xlen == 64
+#define COUNTERS_READ64(csr)	((ULL)read_csr(csr))
+#else
+#define COUNTERS_READ64(csr)	({ UI __hi, __lo; \
+	do { __hi = read_csr(csr##h); __lo = read_csr(csr); } while(__hi != read_csr(csr##h)); \
+	((ULL)__hi << 32) | __lo; })
+#endif
+
+typedef struct
+{
+	ULL cycles;
+	ULL instret;
+	ULL hpm[COUNTERS_HPM];
+}COUNTERS_type;
+
+typedef struct
+{
+	const char *name;
+	UI runs;
+	COUNTERS_type total;
+	COUNTERS_type start;
+}COUNTER_REGION_type;
+
+
+/*  Function declarations
+*
+***************************************************/
+
+/** @fn counters_cycles
+ * @brief  Cycle counter.
+ * @details
+ * @warning
+ * @param[in] No input parameter.
+ * @param[Out] mcycle.
+*/
+static inline __attribute__((always_inline)) ULL counters_cycles(void) {
+
+	return COUNTERS_READ64(mcycle);
+}
+
+/** @fn counters_instret
+ * @brief  Retired instruction counter.
+ * @details
+ * @warning
+ * @param[in] No input parameter.
+ * @param[Out] minstret.
+*/
+static inline __attribute__((always_inline)) ULL counters_instret(void) {
+
+	return COUNTERS_READ64(minstret);
+}
+
+void counters_init(void);
+void counters_read(COUNTERS_type *c);
+ULL counters_hpm(UC n);
+UC counters_set_event(UC n, UL event);
+int counters_region(const char *name);
+void counters_start(int region);
+void counters_stop(int region);
+const COUNTER_REGION_type *counters_get(int region);
+void counters_reset(void);
+void counters_report(void);
+
+
+#endif /* COUNTERS_H_ */
@@ -0,0 +1,38 @@
+#ifndef DELAY_H_
+#define DELAY_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for CORE_CLOCK_HZ and TIMER_CLOCK_HZ
+
+/*  Defines section
+*
+*   Delays counted on the 64 bit time base. Until delay_init has run they
+*   assume the core runs at CORE_CLOCK_HZ. delay_init measures the core clock
+*   against a hardware timer running at TIMER_CLOCK_HZ, updates the time base
+*   conversions and keeps that timer to wake the core from wfi, so that long
+*   waits sleep instead of spinning.
+***************************************************/
+
+#define DELAY_CAL_CLOCKS	(TIMER_CLOCK_HZ / 100)	// 10 ms calibration.
+#define DELAY_SLEEP_MIN_US	50	// Shorter waits spin, a wfi wake up costs more.
+
+
+/*  Function declarations
+*
+***************************************************/
+
+void delay_init(UC timer_no);
+UL delay_core_hz(void);
+void delay_cycles(ULL cycles);
+void delay_us(UI us);
+void delay_ms(UI ms);
+void sleep_until(ULL deadline);
+
+
+#endif /* DELAY_H_ */
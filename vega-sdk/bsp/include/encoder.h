@@ -0,0 +1,38 @@
+#ifndef ENCODER_H_
+#define ENCODER_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for datatypes
+
+/*  Defines section
+*
+*   Quadrature encoders sampled from a fast timer interrupt. Both ports are
+*   read with one load each per tick and every encoder is decoded with a 16
+*   entry transition table indexed by its previous and current A/B levels.
+*   Counts and velocity are updated in the ISR, so the caller never polls.
+***************************************************/
+
+#define ENCODER_MAX		4
+
+
+/*  Function declarations
+*
+***************************************************/
+
+void encoder_init(US window_ticks);
+int encoder_add(US pin_a, US pin_b);
+void encoder_start(UC timer_no, UI tick_clocks);
+void encoder_stop(void);
+int encoder_count(UC encoder);
+int encoder_velocity(UC encoder);
+UI encoder_errors(UC encoder);
+void encoder_reset(UC encoder);
+
+
+#endif /* ENCODER_H_ */
@@ -7,6 +7,8 @@
 /*  Include section
 *
 ***************************************************/
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for base addresses
 
 
 /*  Defines section
@@ -66,6 +68,33 @@
 #define HIGH			1
 #define LOW			0
 
+#define GPIO_DIR_IN		0x0000	// Direction value with every pin as INPUT.
+#define GPIO_DIR_OUT		0xFFFF	// Direction value with every pin as OUTPUT.
+
+#define GPIO_PULSE_OK		0	// Pulse measured.
+#define GPIO_PULSE_NO_EDGE	1	// Pulse did not start before the deadline.
+#define GPIO_PULSE_TOO_LONG	2	// Pulse did not end before the deadline.
+#define GPIO_PULSE_BUSY		3	// Interrupt driven capture still running.
+
+#define GPIO_PULSE_TIMEOUT_US	1000000	// Deadline used by pulse_duration.
+
+#define GPIO_DIR_OFFSET		0x40000	// Direction register offset from port base.
+#define GPIO_PORT_BASE(port)	((port) == GPIO_0 ? GPIO_0_BASE_ADDRESS : GPIO_1_BASE_ADDRESS)
+
+/*  Compile time pin access
+*
+*   For a constant pin the mask and the masked data address are constant
+*   expressions, so GPIO_PIN_SET(PIN_5) is a single store even at -O0.
+*   The pin must already have its direction set (GPIO_config_pin/GPIO_set_dir).
+***************************************************/
+#define GPIO_PIN_MASK(pin)	((US)(1U << ((pin) & 15)))
+#define GPIO_PIN_REG(pin)	((volatile US *)(GPIO_PORT_BASE((pin) > 15) + ((UL)GPIO_PIN_MASK(pin) << 2)))
+
+#define GPIO_PIN_SET(pin)	(*GPIO_PIN_REG(pin) = GPIO_PIN_MASK(pin))
+#define GPIO_PIN_CLR(pin)	(*GPIO_PIN_REG(pin) = 0)
+#define GPIO_PIN_WRITE(pin, v)	(*GPIO_PIN_REG(pin) = (v) ? GPIO_PIN_MASK(pin) : 0)
+#define GPIO_PIN_READ(pin)	(*GPIO_PIN_REG(pin) != 0)
+
 /*  Function declarations
 *
 ***************************************************/
@@ -73,5 +102,35 @@
 US GPIO_read_pin(US pin_no);
 void GPIO_write_pin(US pin_no,US data);
 UL pulse_duration(US pin_number, US val);
+UC GPIO_pulse_measure(US pin_no, US level, UL timeout_us, UL *width_us);
+void GPIO_pulse_capture_start(US pin_no, US level, UL timeout_us, UC timer_no, UI sample_clocks);
+UC GPIO_pulse_capture_status(UL *width_us);
+void GPIO_config_pin(US pin_no, US dir);
+void GPIO_write_port(UC port, US mask, US value);
+US GPIO_read_port(UC port, US mask);
+void GPIO_set_dir(UC port, US mask, US dir);
+
+/** @fn GPIO_put_pin
+ * @brief  Write a pin configured with GPIO_config_pin.
+ * @details Single store to the masked data address, no direction access and no fence.
+ *	    With optimisation a constant pin folds like GPIO_PIN_WRITE.
+ * @warning The pin must already be an OUTPUT.
+ * @param[in] unsigned short pin_no, unsigned short data
+ * @param[Out] No output parameter.
+*/
+static inline __attribute__((always_inline)) void GPIO_put_pin(US pin_no, US data) {
+	GPIO_PIN_WRITE(pin_no, data);
+}
+
+/** @fn GPIO_get_pin
+ * @brief  Read a pin configured with GPIO_config_pin.
+ * @details Single load from the masked data address, no direction access and no fence.
+ * @warning The pin must already be an INPUT.
+ * @param[in] unsigned short pin_no
+ * @param[Out] Pin value 1 or 0.
+*/
+static inline __attribute__((always_inline)) US GPIO_get_pin(US pin_no) {
+	return GPIO_PIN_READ(pin_no);
+}
 
 #endif /* GPIO_H_ */
@@ -0,0 +1,68 @@
+#ifndef __I2C_SCHED_H
+#define __I2C_SCHED_H
+/***************************************************
+
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: i2c_sched.h
+ Purpose		: I2C sensor polling scheduler header file
+ Description		: Periodic I2C read transactions driven by a timer
+
+ See LICENSE for license details.
+ ***************************************************/
+/**
+ @file i2c_sched.h
+ @brief header file for the I2C polling scheduler
+ @detail Each device registers one read transaction and a period in
+ scheduler ticks. A hardware timer releases the transactions and
+ i2c_sched_poll() runs all released ones back-to-back on the bus. The
+ result of every device lands in its own double buffer.
+ */
+
+/*  Include section
+ *
+ ***************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+
+
+/*  Defines section
+ *
+ ***************************************************/
+
+#define I2C_SCHED_MAX_DEVICES		8
+#define I2C_SCHED_MAX_READ		16	// Controller read FIFO depth.
+#define I2C_SCHED_MAX_REG		2
+
+#define I2C_SCHED_OK			0
+#define I2C_SCHED_NACK			1
+
+typedef struct {
+	UC i2c_number;			// I2C_0 or I2C_1.
+	UC slave_address;		// 7 bit slave address.
+	UC reg[I2C_SCHED_MAX_REG];	// Register/command bytes written before the read.
+	UC reg_length;			// 0 to I2C_SCHED_MAX_REG.
+	UC read_length;			// 1 to I2C_SCHED_MAX_READ.
+	UI period;			// Period in scheduler ticks.
+	UI phase;			// First release, in ticks after i2c_sched_start().
+} I2C_SCHED_XFER;
+
+
+/*  Function declaration section
+ *
+ ***************************************************/
+
+void i2c_sched_init(void);
+int i2c_sched_add(const I2C_SCHED_XFER *xfer);
+void i2c_sched_remove(UC dev);
+void i2c_sched_start(UC timer_no, UI tick_clocks);
+void i2c_sched_stop(void);
+UC i2c_sched_poll(void);
+UI i2c_sched_read(UC dev, UC *data);
+UI i2c_sched_errors(UC dev);
+UI i2c_sched_overruns(UC dev);
+
+#endif /*__I2C_SCHED_H*/
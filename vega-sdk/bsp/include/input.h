@@ -0,0 +1,56 @@
+#ifndef INPUT_H_
+#define INPUT_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for datatypes
+
+/*  Defines section
+*
+*   Debounced inputs on the GPIO ports. A timer interrupt samples both ports
+*   and runs a two bit vertical counter for all 32 pins in parallel: a pin
+*   changes its debounced state after INPUT_DEBOUNCE_SAMPLES equal samples.
+*   Press, release and hold events are queued with the time base cycle count
+*   of the sample that produced them.
+***************************************************/
+
+#define INPUT_DEBOUNCE_SAMPLES	4	// Fixed by the two bit vertical counter.
+
+#define INPUT_EVENT_PRESS	0
+#define INPUT_EVENT_RELEASE	1
+#define INPUT_EVENT_HOLD	2	// Pin held for hold_ticks, repeated every hold_ticks.
+
+#define INPUT_ACTIVE_HIGH	0
+#define INPUT_ACTIVE_LOW	1	// Pin pulled up, pressed when low.
+
+#ifndef INPUT_QUEUE_SIZE
+#define INPUT_QUEUE_SIZE	16	// Power of two.
+#endif
+
+typedef struct
+{
+	UC pin_no;
+	UC type;			// INPUT_EVENT_PRESS, INPUT_EVENT_RELEASE or INPUT_EVENT_HOLD.
+	ULL time;			// time_now_cycles of the sample.
+}INPUT_EVENT_type;
+
+
+/*  Function declarations
+*
+***************************************************/
+
+void input_init(US hold_ticks);
+int input_add(US pin_no, UC active);
+void input_start(UC timer_no, UI tick_clocks);
+void input_stop(void);
+UC input_get_event(INPUT_EVENT_type *event);
+UI input_state(void);
+UI input_dropped(void);
+
+
+#endif /* INPUT_H_ */
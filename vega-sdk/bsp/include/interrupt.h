@@ -31,6 +31,7 @@
 *
 ***************************************************/
 typedef void (*fp)(void); //Declares a type of a void function that accepts an void
+typedef void (*irq_handler)(void *ctx);	// Interrupt handler, ctx as given to irq_register.
 
 typedef struct interrupt_reg
 {
@@ -40,22 +41,70 @@ typedef struct interrupt_reg
 	UL   INTR_STATUS; 	//0x10
 #else
 	UI   RAW_INTR; 		//0x00
-	UI   dummy0; 		//0x04
+	UI   RAW_INTR_H; 	//0x04	Sources 32..63.
 	UI   INTR_EN; 		//0x08
-	UI   dummy1; 		//0x0c
+	UI   INTR_EN_H; 	//0x0c
 	UI   INTR_STATUS; 	//0x10
+	UI   INTR_STATUS_H; 	//0x14
 #endif
 }INTR_REG;
 
 #define intr_regs (*((volatile INTR_REG *)0x20010000))
+
+/* Interrupt controller lines of each SoC. The build passes
+*  -DVEGA_MACHINE_<MACHINE> from config.mk; without it the SoC is taken
+*  from the register width.
+*/
+#if !defined(VEGA_MACHINE_THEJAS32) && !defined(VEGA_MACHINE_THEJAS64) && !defined(VEGA_MACHINE_CDAC)
+#if __riscv_xlen == 64
+#define VEGA_MACHINE_THEJAS64
+#else
+#define VEGA_MACHINE_THEJAS32
+#endif
+#endif
+
+#if defined(VEGA_MACHINE_THEJAS32)
+#define TIMER_0_IRQ		7	// Timers 0,1,2 interrupt at 7,8,9 on THEJAS32.
+#elif defined(VEGA_MACHINE_THEJAS64)
+#define TIMER_0_IRQ		10	// Timers 0,1,2 interrupt at 10,11,12 on THEJAS64.
+#elif defined(VEGA_MACHINE_CDAC)
+#define TIMER_0_IRQ		10	// Timers 0,1,2 interrupt at 10,11,12 on the CDAC board.
+#endif
+#define TIMER_IRQ(n)		(TIMER_0_IRQ + (n))
+
+#define INTR_SOURCES		64	// Sources without a handler run interrupt_unhandled.
+
+#define IRQ_PRIORITIES		4	// Pending sources are served highest priority first.
+#define IRQ_PRIORITY_LOWEST	0	// Lines without a handler.
+#define IRQ_PRIORITY_DEFAULT	1
+#define IRQ_PRIORITY_HIGHEST	(IRQ_PRIORITIES - 1)
+
+typedef struct
+{
+	irq_handler handler;
+	void *ctx;
+}IRQ_ENTRY_type;
+
+extern IRQ_ENTRY_type irq_table[INTR_SOURCES];
+extern volatile ULL interrupt_unhandled_lines;
+
 /*  Function declaration section
 * 
 *
 ***************************************************/
 void enable_irq(void);
 void interrupt_enable(UC intr_number);
+void interrupt_disable(UC intr_number);
 void initialize_interrupt_table(void);
 void interrupt_handler(void);
+void interrupt_unhandled(void *ctx);
+void irq_register(UC irq, irq_handler handler, void *ctx, UC priority);
+void irq_unregister(UC irq);
+void irq_set_priority(UC irq, UC priority);
+void irq_nesting(UC enable);
+UC irq_current_priority(void);
+void machine_timer_interrupt_handler(void);
+void software_interrupt_handler(void);
 
 #endif	/* _INTERRUPT_H */	
 
@@ -0,0 +1,57 @@
+#ifndef IRQ_STATS_H_
+#define IRQ_STATS_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for datatypes
+
+/*  Defines section
+*
+*   Interrupt instrumentation, built in with VEGA_IRQ_STATS=1 (see
+*   config.mk). The interrupt entry records mcycle, interrupt_handler
+*   records it again before and after each handler. Per source the latency,
+*   entry to handler, and the service time, handler start to return, are
+*   kept as min/max/mean and as a histogram of IRQ_STATS_BINS power of two
+*   bins. With nesting the service time includes the nested handlers.
+*   Without VEGA_IRQ_STATS nothing is recorded and the calls compile away.
+***************************************************/
+
+#define IRQ_STATS_BINS		8	// [0,32) [32,64) ... [2048,...) cycles.
+#define IRQ_STATS_BIN0_SHIFT	5
+
+typedef struct
+{
+	UI count;
+	UI lat_min, lat_max;
+	ULL lat_sum;
+	UI svc_min, svc_max;
+	ULL svc_sum;
+	UI lat_hist[IRQ_STATS_BINS];
+	UI svc_hist[IRQ_STATS_BINS];
+}IRQ_STATS_type;
+
+
+/*  Function declarations
+*
+***************************************************/
+
+#ifdef VEGA_IRQ_STATS
+extern volatile UI irq_stats_entry;	// mcycle at the interrupt entry, written by crt.S.
+
+void irq_stats_record(UC irq, UI entry, UI start, UI end);
+void irq_stats_reset(void);
+void irq_stats_dump(void);
+const IRQ_STATS_type *irq_stats_get(UC irq);
+#else
+#define irq_stats_reset()	do { } while(0)
+#define irq_stats_dump()	do { } while(0)
+#define irq_stats_get(irq)	((const IRQ_STATS_type *)0)
+#endif
+
+
+#endif /* IRQ_STATS_H_ */
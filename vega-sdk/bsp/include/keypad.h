@@ -0,0 +1,41 @@
+#ifndef KEYPAD_H_
+#define KEYPAD_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for datatypes
+
+/*  Defines section
+*
+*   Matrix keypad scanned from a timer interrupt. Every tick reads the columns
+*   of the row selected at the previous tick, then selects the next row with
+*   one masked write per port, so the lines settle between ticks. Rows are
+*   driven low one at a time and the columns need pull-ups. A key changes
+*   state when two full scans agree.
+***************************************************/
+
+#define KEYPAD_ROWS		4
+#define KEYPAD_COLS		4
+
+#ifndef KEYPAD_QUEUE_SIZE
+#define KEYPAD_QUEUE_SIZE	8	// Power of two.
+#endif
+
+
+/*  Function declarations
+*
+***************************************************/
+
+int keypad_init(const US *row_pins, const US *col_pins);
+void keypad_start(UC timer_no, UI tick_clocks);
+void keypad_stop(void);
+UC keypad_get_event(UC *key, UC *pressed);
+US keypad_state(void);
+
+
+#endif /* KEYPAD_H_ */
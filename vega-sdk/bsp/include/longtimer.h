@@ -0,0 +1,45 @@
+#ifndef LONGTIMER_H_
+#define LONGTIMER_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for TIMER_CLOCK_HZ
+#include "timer.h"	//for timer_callback
+
+/*  Defines section
+*
+*   64 bit one shot and periodic timeouts on the 32 bit hardware timers. A
+*   timeout is split into segments of at most LONGTIMER_MAX_CLOCKS that run
+*   back to back in the periodic mode of the timer: the interrupt at the end
+*   of a segment only writes the reload value of the segment after the one
+*   already running, so the counter never stops and no clock is lost between
+*   segments or periods. Segments are never shorter than LONGTIMER_MIN_CLOCKS,
+*   which must cover the interrupt latency.
+***************************************************/
+
+#ifndef LONGTIMER_MIN_CLOCKS
+#define LONGTIMER_MIN_CLOCKS	4096		// Shortest segment, and timeout.
+#endif
+#define LONGTIMER_MAX_CLOCKS	0xFFFFFFFFUL	// Longest segment.
+
+#define LONGTIMER_US(us)	((ULL)(us) * (TIMER_CLOCK_HZ / 1000000))
+#define LONGTIMER_MS(ms)	((ULL)(ms) * (TIMER_CLOCK_HZ / 1000))
+#define LONGTIMER_S(s)		((ULL)(s) * TIMER_CLOCK_HZ)
+
+
+/*  Function declarations
+*
+***************************************************/
+
+void longtimer_start(UC timer_no, ULL clocks, ULL period, timer_callback fn, void *ctx);
+void longtimer_stop(UC timer_no);
+UC longtimer_active(UC timer_no);
+ULL longtimer_remaining(UC timer_no);
+
+
+#endif /* LONGTIMER_H_ */
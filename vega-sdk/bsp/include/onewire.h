@@ -0,0 +1,39 @@
+#ifndef ONEWIRE_H_
+#define ONEWIRE_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for datatypes
+
+/*  Defines section
+*
+*   1-Wire bus master on a GPIO pin, timed with the bit-bang engine. The pin
+*   is used as an open drain output: it is driven low by making it OUTPUT and
+*   released by making it INPUT, so the bus needs an external pull-up.
+*   Interrupts are masked for the timed part of each slot only.
+***************************************************/
+
+#define ONEWIRE_CMD_SKIP_ROM	0xCC
+#define ONEWIRE_CMD_READ_ROM	0x33
+#define ONEWIRE_CMD_MATCH_ROM	0x55
+
+
+/*  Function declarations
+*
+***************************************************/
+
+void onewire_init(US pin_no);
+UC onewire_reset(US pin_no);
+void onewire_write_bit(US pin_no, UC bit);
+UC onewire_read_bit(US pin_no);
+void onewire_write_byte(US pin_no, UC data);
+UC onewire_read_byte(US pin_no);
+UC onewire_crc8(const UC *data, UC len);
+
+
+#endif /* ONEWIRE_H_ */
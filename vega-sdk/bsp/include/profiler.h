@@ -0,0 +1,46 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for datatypes
+
+/*  Defines section
+*
+*   Statistical PC sampling. A hardware timer interrupt reads mepc, the
+*   address the program was interrupted at, and counts it in a histogram of
+*   PROFILER_BUCKETS buckets of 2^shift bytes over the program image, from
+*   _start to _end. The shift is the smallest that covers the image. A small
+*   pseudo random jitter is added to the sampling period so that periodic
+*   code is not sampled in lock step. profiler_dump sends the histogram over
+*   the debug UART in binary, tools/vega_prof.py maps it to functions.
+*
+*   Dump format, little endian:
+*     "VPRF", UI base, UC shift, UC 0, US buckets, UI samples, UI outside,
+*     then US index, UI count for every non empty bucket, then US 0xFFFF.
+***************************************************/
+
+#ifndef PROFILER_BUCKETS
+#define PROFILER_BUCKETS	2048	// Power of two, 4 bytes each.
+#endif
+#define PROFILER_JITTER_MASK	0xFF	// Timer clocks added to each period.
+#define PROFILER_END		0xFFFF
+
+
+/*  Function declarations
+*
+***************************************************/
+
+void profiler_start(UC timer_no, UI period_clocks);
+void profiler_stop(void);
+void profiler_reset(void);
+void profiler_dump(void);
+UI profiler_samples(void);
+
+
+#endif /* PROFILER_H_ */
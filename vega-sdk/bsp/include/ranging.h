@@ -0,0 +1,40 @@
+#ifndef RANGING_H_
+#define RANGING_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for datatypes
+
+/*  Defines section
+*
+*   Ultrasonic ranging engine for HC-SR04 style sensors. One timer interrupt
+*   fires the triggers on a fixed schedule and samples the echo pins of all
+*   sensors with one load per GPIO port. Echo edges are time stamped on the
+*   time base and the distances are published without blocking the caller.
+***************************************************/
+
+#define RANGING_MAX_SENSORS	8
+#define RANGING_MAX_EVENTS	RANGING_MAX_SENSORS
+
+#define RANGING_NO_ECHO		0xFFFF		// Published when no valid echo was seen.
+#define RANGING_MAX_ECHO_US	25000		// Longer echoes are reported as RANGING_NO_ECHO (~4.3 m).
+#define RANGING_SOUND_MM_S	343000UL	// Speed of sound at 20 C.
+
+
+/*  Function declarations
+*
+***************************************************/
+
+void ranging_init(UI period_ticks);
+int ranging_add(US trig_pin, US echo_pin, UI fire_tick);
+void ranging_start(UC timer_no, UI tick_clocks);
+void ranging_stop(void);
+UI ranging_read(UC sensor, US *distance_mm);
+
+
+#endif /* RANGING_H_ */
@@ -0,0 +1,42 @@
+#ifndef SOFT_PWM_H_
+#define SOFT_PWM_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for datatypes
+
+/*  Defines section
+*
+*   Software PWM over the GPIO ports. Every channel has a duty and a phase in
+*   steps of the PWM period. The channel edges are kept in a list sorted by
+*   step and the timer interrupts only at the steps where an edge is due, so
+*   the CPU load depends on the number of distinct edges, not on the PWM
+*   resolution. All edges of a step are applied with one masked write per port.
+***************************************************/
+
+#define SOFT_PWM_MAX_CHANNELS	32
+#define SOFT_PWM_MAX_EDGES	(2 * SOFT_PWM_MAX_CHANNELS + 1)
+
+#ifndef SOFT_PWM_MIN_GAP_CLOCKS
+#define SOFT_PWM_MIN_GAP_CLOCKS	400	// Edges closer than this are applied together.
+#endif
+
+
+/*  Function declarations
+*
+***************************************************/
+
+void soft_pwm_init(UI period_clocks, US steps);
+int soft_pwm_add(US pin_no);
+void soft_pwm_set(UC channel, US duty, US phase);
+void soft_pwm_update(void);
+void soft_pwm_start(UC timer_no);
+void soft_pwm_stop(void);
+
+
+#endif /* SOFT_PWM_H_ */
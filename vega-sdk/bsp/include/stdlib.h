@@ -24,12 +24,13 @@ typedef unsigned char  UC;	//1 Byte
 typedef unsigned int   UI;	//4 Bytes
 typedef unsigned long  UL;	//4 Bytes
 typedef unsigned short US;	//2 Bytes
+typedef unsigned long long ULL;	//8 Bytes
 
 int printf(const char* fmt, ...);
 int putchar(int ch);
 int delay(unsigned int count);
 int udelay(unsigned int count);
-clock_t get_time();
+clock_t get_time();	// Low word of time_now_cycles() on 32 bit processors.
 
 
 #endif /* INCLUDE_STDLIB_H_ */
@@ -0,0 +1,69 @@
+#ifndef SWTIMER_H_
+#define SWTIMER_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for datatypes
+#include "timebase.h"	//for the tick length
+
+/*  Defines section
+*
+*   Software timers on one hardware timer. Pending timers sit in a
+*   hierarchical wheel of SWTIMER_LEVELS levels of 64 slots: level n holds
+*   the timers due within 64^(n+1) ticks and is moved down one level when
+*   the lower level wraps. Start and cancel are O(1). The hardware timer is
+*   programmed for the next tick with work to do, found from a bitmap of the
+*   occupied slots of every level, so idle ticks cost nothing. Callbacks run
+*   in the timer interrupt, or from swtimer_run_deferred() for timers set up
+*   with SWTIMER_DEFERRED.
+***************************************************/
+
+#ifndef SWTIMER_TICK_US
+#define SWTIMER_TICK_US		1000	// Tick length, CORE_CLOCK_HZ based.
+#endif
+#define SWTIMER_TICK_CYCLES	TIME_US2CYC(SWTIMER_TICK_US)
+#define SWTIMER_MS(ms)		((UI)(((ULL)(ms) * 1000 + SWTIMER_TICK_US - 1) / SWTIMER_TICK_US))
+
+#define SWTIMER_LEVELS		4	// 2^24 ticks ahead, longer timers are cascaded again.
+#define SWTIMER_SLOTS		64
+
+#define SWTIMER_DEFERRED	0x01	// Callback runs from swtimer_run_deferred.
+
+typedef void (*swtimer_fn)(void *ctx);
+
+typedef struct swtimer
+{
+	struct swtimer *next;		// Slot list.
+	struct swtimer **pprev;		// Link pointing at this timer, 0 when not pending.
+	struct swtimer *deferred_next;	// Deferred queue.
+	ULL expires;			// Tick.
+	UI period;			// Ticks, 0 for a one shot timer.
+	swtimer_fn fn;
+	void *ctx;
+	UC level;
+	UC slot;
+	UC flags;
+	UC queued;			// In the deferred queue.
+	volatile UC run;		// Deferred callback due.
+}SWTIMER_type;
+
+
+/*  Function declarations
+*
+***************************************************/
+
+void swtimer_init(UC timer_no);
+void swtimer_setup(SWTIMER_type *t, swtimer_fn fn, void *ctx, UC flags);
+void swtimer_start(SWTIMER_type *t, UI delay_ticks, UI period_ticks);
+void swtimer_cancel(SWTIMER_type *t);
+UC swtimer_pending(SWTIMER_type *t);
+UI swtimer_run_deferred(void);
+ULL swtimer_now(void);
+
+
+#endif /* SWTIMER_H_ */
@@ -0,0 +1,127 @@
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for CORE_CLOCK_HZ
+#include "encoding.h"	//for read_csr
+
+/*  Defines section
+*
+*   64 bit monotonic time base counted in core cycles. On 32 bit processors
+*   mcycleh is read before and after mcycle and the read is repeated if it
+*   changed, so a carry between the two halves is never seen half done.
+*   Conversions multiply by 32.32 fixed point factors derived from the core
+*   clock; they start from CORE_CLOCK_HZ and are replaced when delay_init
+*   measures the real clock.
+***************************************************/
+
+// Compile time conversions, for constants.
+#define TIME_NS2CYC(ns)		((UI)(((ULL)(ns) * CORE_CLOCK_HZ + 500000000ULL) / 1000000000ULL))
+#define TIME_US2CYC(us)		((UI)(((ULL)(us) * CORE_CLOCK_HZ + 500000ULL) / 1000000ULL))
+#define TIME_MS2CYC(ms)		((ULL)(ms) * CORE_CLOCK_HZ / 1000ULL)
+
+// 32.32 factor converting at rate num per second to rate den per second.
+#define TIME_SCALE_Q32(num, den)	((((ULL)(num) << 32) + (den) / 2) / (den))
+
+typedef struct
+{
+	UL core_hz;
+	ULL cyc2ns;			// Nanoseconds per cycle, 32.32.
+	ULL cyc2us;
+	ULL cyc2ms;
+	ULL ns2cyc;			// Cycles per nanosecond, 32.32.
+	ULL us2cyc;
+	ULL ms2cyc;
+}TIME_SCALE_type;
+
+extern TIME_SCALE_type time_scale;
+
+
+/*  Function definitions
+*
+***************************************************/
+
+/** @fn time_now_cycles
+ * @brief  Cycles since reset.
+ * @details Does not wrap for 14000 years at 40 MHz.
+ * @warning
+ * @param[in] No input parameter.
+ * @param[Out] 64 bit cycle count.
+*/
+static inline __attribute__((always_inline)) ULL time_now_cycles(void) {
+
+#if __riscv_xlen == 64
+	return read_csr(mcycle);
+#else
+	UI hi, lo;
+
+	do {
+		hi = read_csr(mcycleh);
+		lo = read_csr(mcycle);
+	} while(hi != read_csr(mcycleh));		// Low half carried between the reads.
+	return ((ULL)hi << 32) | lo;
+#endif
+}
+
+/** @fn time_now_cycles32
+ * @brief  Low word of the time base.
+ * @details One CSR read, for busy waits on short intervals with a signed difference.
+ * @warning Wraps every 2^32 cycles on 32 bit processors.
+ * @param[in] No input parameter.
+ * @param[Out] Cycle count.
+*/
+static inline __attribute__((always_inline)) UL time_now_cycles32(void) {
+
+	return read_csr(mcycle);
+}
+
+/** @fn time_scale_q32
+ * @brief  Multiply a 64 bit value by a 32.32 factor.
+ * @details Split in 32 bit halves so no partial product overflows. The result is
+ *	    truncated, exact to one unit.
+ * @warning
+ * @param[in] unsigned long long value, unsigned long long factor
+ * @param[Out] value * factor.
+*/
+static inline ULL time_scale_q32(ULL value, ULL factor) {
+
+	UI vh = value >> 32, vl = (UI)value;
+	UI fi = factor >> 32, ff = (UI)factor;
+
+	return value * fi + (ULL)vh * ff + (((ULL)vl * ff) >> 32);
+}
+
+static inline ULL time_cycles_to_ns(ULL cycles) { return time_scale_q32(cycles, time_scale.cyc2ns); }
+static inline ULL time_cycles_to_us(ULL cycles) { return time_scale_q32(cycles, time_scale.cyc2us); }
+static inline ULL time_cycles_to_ms(ULL cycles) { return time_scale_q32(cycles, time_scale.cyc2ms); }
+static inline ULL time_ns_to_cycles(ULL ns) { return time_scale_q32(ns, time_scale.ns2cyc); }
+static inline ULL time_us_to_cycles(ULL us) { return time_scale_q32(us, time_scale.us2cyc); }
+static inline ULL time_ms_to_cycles(ULL ms) { return time_scale_q32(ms, time_scale.ms2cyc); }
+
+/** @fn time_now_us
+ * @brief  Microseconds since reset.
+ * @details
+ * @warning
+ * @param[in] No input parameter.
+ * @param[Out] Microseconds.
+*/
+static inline ULL time_now_us(void) {
+
+	return time_cycles_to_us(time_now_cycles());
+}
+
+
+/*  Function declarations
+*
+***************************************************/
+
+void time_set_core_hz(UL core_hz);
+
+
+#endif /* TIMEBASE_H_ */
@@ -34,6 +34,15 @@ typedef struct
 
 #define Timer(n) (*((volatile TimerReg_type *)(TIMER_BASE_ADDRESS + (n * 20))))
 
+#define TIMER_COUNT	3
+
+/* The timer interrupt handlers acknowledge the interrupt and call the
+*  callback registered for the timer with timer_set_callback, with
+*  interrupts masked, or only the lower priorities with irq_nesting.
+*  Callbacks should be short and must not print.
+*/
+typedef void (*timer_callback)(void *ctx);
+
 /*  Function declarations
 *
 ***************************************************/
@@ -45,6 +54,8 @@ UI timer_get_current_value(UC timer_no);
 void timer_run_in_intr_mode(UC timer_no, UI no_of_clocks);
 void timer_unmask_intr(UC timer_no); 	
 void timer_load(UC timer_no,UI count); 
+void timer_set_callback(UC timer_no, timer_callback fn, void *ctx);
+void timer_intr_handler(void *ctx);
 void timer0_intr_handler(void); 	
 void timer1_intr_handler(void);
 void timer2_intr_handler(void);
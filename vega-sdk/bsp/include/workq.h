@@ -0,0 +1,56 @@
+#ifndef WORKQ_H_
+#define WORKQ_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for datatypes
+#include "interrupt.h"	//for IRQ_PRIORITIES
+
+/*  Defines section
+*
+*   Deferred interrupt work. An interrupt handler posts a function with a
+*   copy of up to WORKQ_PAYLOAD bytes of data and returns; the main loop
+*   runs the posted work with interrupts enabled, from workq_run() or
+*   workq_idle(). There is one ring per interrupt priority and the higher
+*   priorities are drained first. Posted with WORKQ_PRIORITY_CURRENT, work
+*   takes the priority interrupt_handler is dispatching. Posting masks interrupts only for the copy
+*   into the ring, running the work never masks them.
+***************************************************/
+
+#ifndef WORKQ_DEPTH
+#define WORKQ_DEPTH		16	// Items per priority, power of two.
+#endif
+#ifndef WORKQ_PAYLOAD
+#define WORKQ_PAYLOAD		8	// Bytes copied with each item.
+#endif
+
+#define WORKQ_PRIORITY_CURRENT	0xFF	// Priority of the interrupt posting.
+
+typedef void (*workq_fn)(void *ctx, const UC *data, UC len);
+
+typedef struct
+{
+	workq_fn fn;
+	void *ctx;
+	UC data[WORKQ_PAYLOAD];		// Pointer aligned, may hold a struct.
+	UC len;
+}WORKQ_ITEM_type;
+
+
+/*  Function declarations
+*
+***************************************************/
+
+UC workq_post(UC priority, workq_fn fn, void *ctx, const void *data, UC len);
+UI workq_run(void);
+void workq_idle(void);
+UC workq_pending(void);
+UI workq_dropped(void);
+
+
+#endif /* WORKQ_H_ */
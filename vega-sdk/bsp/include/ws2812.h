@@ -0,0 +1,33 @@
+#ifndef WS2812_H_
+#define WS2812_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for datatypes
+
+/*  Defines section
+*
+*   WS2812 LED strips on a GPIO pin, sent with the bit-bang engine. Colours
+*   are 3 bytes per LED in green, red, blue order.
+***************************************************/
+
+#define WS2812_T0H_NS		400
+#define WS2812_T1H_NS		800
+#define WS2812_PERIOD_NS	1250
+#define WS2812_RESET_US		280	// Low time latching the data, newer parts need 280 us.
+
+
+/*  Function declarations
+*
+***************************************************/
+
+void ws2812_init(US pin_no);
+void ws2812_write(US pin_no, const UC *grb, US leds);
+
+
+#endif /* WS2812_H_ */
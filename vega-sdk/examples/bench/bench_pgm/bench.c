@@ -0,0 +1,150 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: bench.c
+ Purpose		: Microbenchmark harness
+ Description		: Warm-up, timed runs and min, median and max of every case
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "counters.h"
+#include "bench.h"
+
+static UI overhead_cycles, overhead_instret;
+
+
+/** @fn bench_nop
+ * @brief Empty case.
+ * @details
+ * @warning
+ * @param[in] void *arg: not used.
+ * @param[Out] No output parameter
+*/
+static void bench_nop(void *arg)
+{
+}
+
+
+/** @fn bench_time
+ * @brief Time one run of a case.
+ * @details Not inlined, so the empty case and the measured cases are timed by the same code.
+ * @warning
+ * @param[in] bench_fn fn, void *arg
+ * @param[Out] unsigned int *cycles, unsigned int *instret
+*/
+static __attribute__((noinline)) void bench_time(bench_fn fn, void *arg, UI *cycles, UI *instret)
+{
+	ULL c0, i0, c1, i1;
+
+	i0 = counters_instret();
+	c0 = counters_cycles();
+	fn(arg);
+	c1 = counters_cycles();
+	i1 = counters_instret();
+
+	*cycles = (UI)(c1 - c0);
+	*instret = (UI)(i1 - i0);
+}
+
+
+/** @fn bench_sort
+ * @brief Sort the runs.
+ * @details Insertion sort, BENCH_RUNS is small.
+ * @warning
+ * @param[in] unsigned int *v, unsigned int n
+ * @param[Out] No output parameter
+*/
+static void bench_sort(UI *v, UI n)
+{
+	for(UI i = 1; i < n; i++)
+	{
+		UI x = v[i];
+		UI j = i;
+
+		for(; j > 0 && v[j - 1] > x; j--)
+			v[j] = v[j - 1];
+		v[j] = x;
+	}
+}
+
+
+/** @fn bench_less
+ * @brief Take the timing cost off a count.
+ * @details
+ * @warning
+ * @param[in] unsigned int count, unsigned int overhead
+ * @param[Out] The count less the overhead, at least 0.
+*/
+static inline UI bench_less(UI count, UI overhead)
+{
+	return count > overhead ? count - overhead : 0;
+}
+
+
+/** @fn bench_init
+ * @brief Initialise the harness.
+ * @details Measures the cost of timing the empty case, the smallest of BENCH_RUNS runs,
+ *	    and prints the CSV header.
+ * @warning
+ * @param[in] No input parameter
+ * @param[Out] No output parameter
+*/
+void bench_init(void)
+{
+	UI cycles, instret;
+
+	counters_init();
+
+	for(UI r = 0; r < BENCH_WARMUP + BENCH_RUNS; r++)
+	{
+		bench_time(bench_nop, 0, &cycles, &instret);
+		if(r == 0 || cycles < overhead_cycles)
+			overhead_cycles = cycles;
+		if(r == 0 || instret < overhead_instret)
+			overhead_instret = instret;
+	}
+
+	printf("\n\rbench,suite,case,runs,min,median,max,instret");
+}
+
+
+/** @fn bench_run
+ * @brief Run every case of a suite.
+ * @details
+ * @warning
+ * @param[in] const BENCH_SUITE_type *suite
+ * @param[Out] No output parameter
+*/
+void bench_run(const BENCH_SUITE_type *suite)
+{
+	static UI cycles[BENCH_RUNS], instret[BENCH_RUNS];
+	const BENCH_CASE_type *c;
+
+	if(suite->init)
+		suite->init();
+
+	for(c = suite->cases; c->fn; c++)
+	{
+		for(UI r = 0; r < BENCH_WARMUP + BENCH_RUNS; r++)
+		{
+			UI n = r < BENCH_WARMUP ? 0 : r - BENCH_WARMUP;
+
+			if(c->setup)
+				c->setup(c->arg);
+			bench_time(c->fn, c->arg, &cycles[n], &instret[n]);
+		}
+
+		bench_sort(cycles, BENCH_RUNS);
+		bench_sort(instret, BENCH_RUNS);
+		printf("\n\rbench,%s,%s,%d,%u,%u,%u,%u", suite->name, c->name, BENCH_RUNS,
+			bench_less(cycles[0], overhead_cycles),
+			bench_less(cycles[BENCH_RUNS / 2], overhead_cycles),
+			bench_less(cycles[BENCH_RUNS - 1], overhead_cycles),
+			bench_less(instret[BENCH_RUNS / 2], overhead_instret));
+	}
+}
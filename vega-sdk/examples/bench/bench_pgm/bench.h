@@ -0,0 +1,68 @@
+#ifndef BENCH_H_
+#define BENCH_H_
+
+
+
+/*  Include section
+*
+***************************************************/
+
+#include "stdlib.h"	//for datatypes
+#include "config.h"	//for datatypes
+
+/*  Defines section
+*
+*   Microbenchmarks. A suite is a table of cases ending with BENCH_END.
+*   Every case runs BENCH_WARMUP times untimed, to fill the caches and the
+*   branch predictor, then BENCH_RUNS times between reads of mcycle and
+*   minstret. The cost of timing an empty case is taken off every run.
+*   The optional setup function runs before every run, outside the timed
+*   window. bench_run prints one CSV line per case over the debug UART:
+*
+*	bench,suite,case,runs,min,median,max,instret
+*
+*   with cycles for min, median and max and the median instruction count.
+*   Other output of the cases is on lines not starting with "bench,".
+***************************************************/
+
+#ifndef BENCH_WARMUP
+#define BENCH_WARMUP		4
+#endif
+#ifndef BENCH_RUNS
+#define BENCH_RUNS		31	// Odd, the median is a measured run.
+#endif
+
+typedef void (*bench_fn)(void *arg);
+
+typedef struct
+{
+	const char *name;
+	bench_fn setup;			// Untimed, before every run. 0 for none.
+	bench_fn fn;
+	void *arg;
+}BENCH_CASE_type;
+
+typedef struct
+{
+	const char *name;
+	void (*init)(void);		// Once before the first case. 0 for none.
+	const BENCH_CASE_type *cases;
+}BENCH_SUITE_type;
+
+#define BENCH_CASE(name, fn, arg)		{ name, 0, fn, (void *)(arg) }
+#define BENCH_CASE_SETUP(name, setup, fn, arg)	{ name, setup, fn, (void *)(arg) }
+#define BENCH_END				{ 0, 0, 0, 0 }
+
+#define BENCH_SUITE(id, init)	const BENCH_SUITE_type bench_suite_##id = { #id, init, id##_cases }
+#define BENCH_SUITE_DECLARE(id)	extern const BENCH_SUITE_type bench_suite_##id
+
+
+/*  Function declarations
+*
+***************************************************/
+
+void bench_init(void);
+void bench_run(const BENCH_SUITE_type *suite);
+
+
+#endif /* BENCH_H_ */
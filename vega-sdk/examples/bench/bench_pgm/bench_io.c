@@ -0,0 +1,112 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: bench_io.c
+ Purpose		: Microbenchmark harness
+ Description		: Debug UART, SPI and I2C transfer suites
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "spi.h"
+#include "i2c.h"
+#include "bench.h"
+
+#ifndef BENCH_SPI
+#define BENCH_SPI		MDP_SPI_1	// SPI 0 usually has the flash.
+#endif
+#ifndef BENCH_I2C
+#define BENCH_I2C		I2C_0
+#endif
+#ifndef BENCH_I2C_ADDRESS
+#define BENCH_I2C_ADDRESS	0xA2		// 24AA64 EEPROM, write address.
+#endif
+
+/** @fn bench_uart_char
+ * @brief One character on the debug UART.
+ * @details putchar, the printf output path. uart_putchar is not measured, it prints debug
+ *	    messages.
+ * @warning
+ * @param[in] void *arg: not used.
+ * @param[Out] No output parameter
+*/
+static void bench_uart_char(void *arg)
+{
+	putchar('\r');
+}
+
+
+/** @fn bench_spi_init
+ * @brief Suite initialisation.
+ * @details
+ * @warning
+ * @param[in] No input parameter
+ * @param[Out] No output parameter
+*/
+static void bench_spi_init(void)
+{
+	SPI_init(BENCH_SPI);
+}
+
+
+/** @fn bench_spi_write
+ * @brief SPI transmit until the controller is idle.
+ * @details Bytes are zeros, with no device attached the transfer still completes.
+ * @warning
+ * @param[in] void *arg: bytes.
+ * @param[Out] No output parameter
+*/
+static void bench_spi_write(void *arg)
+{
+	for(UI i = 0; i < (UI)(UL)arg; i++)
+		SPI_transmit(BENCH_SPI, 0);
+	SPI_wait_if_busy(BENCH_SPI);
+}
+
+
+/** @fn bench_i2c_write
+ * @brief I2C start, slave address and word address bytes, stop.
+ * @details With arg 1 only the slave address is sent, as the I2C scanner does. With arg 3
+ *	    the EEPROM address pointer is set to 0, no data is written. Completes with a NACK
+ *	    when no device answers.
+ * @warning
+ * @param[in] void *arg: bytes including the slave address, 1 to 3.
+ * @param[Out] No output parameter
+*/
+static void bench_i2c_write(void *arg)
+{
+	UC data[3] = { BENCH_I2C_ADDRESS, 0, 0 };
+
+	i2c_start(BENCH_I2C, 0, 0);
+	i2c_data_write(BENCH_I2C, data, (UC)(UL)arg);
+	i2c_stop(BENCH_I2C);
+}
+
+
+static const BENCH_CASE_type uart_cases[] =
+{
+	BENCH_CASE("debug_char", bench_uart_char, 0),
+	BENCH_END
+};
+
+static const BENCH_CASE_type spi_cases[] =
+{
+	BENCH_CASE("write_1", bench_spi_write, 1),
+	BENCH_CASE("write_16", bench_spi_write, 16),
+	BENCH_END
+};
+
+static const BENCH_CASE_type i2c_cases[] =
+{
+	BENCH_CASE("probe", bench_i2c_write, 1),
+	BENCH_CASE("write_3", bench_i2c_write, 3),
+	BENCH_END
+};
+
+BENCH_SUITE(uart, 0);
+BENCH_SUITE(spi, bench_spi_init);
+BENCH_SUITE(i2c, 0);
@@ -0,0 +1,95 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: bench_irq.c
+ Purpose		: Microbenchmark harness
+ Description		: Interrupt entry and exit suite
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "encoding.h"
+#include "timer.h"
+#include "interrupt.h"
+#include "bench.h"
+
+#ifndef BENCH_IRQ_TIMER
+#define BENCH_IRQ_TIMER		TIMER_0
+#endif
+#define BENCH_IRQ_CLOCKS	100
+
+static volatile UC fired;
+
+
+/** @fn bench_irq_cb
+ * @brief Timer callback.
+ * @details Stops the timer, it would reload and interrupt again.
+ * @warning
+ * @param[in] void *ctx: not used.
+ * @param[Out] No output parameter
+*/
+static void bench_irq_cb(void *ctx)
+{
+	Timer(BENCH_IRQ_TIMER).Control = 0x0;
+	fired = 1;
+}
+
+
+/** @fn bench_irq_init
+ * @brief Suite initialisation.
+ * @details initialize_interrupt_table() must have been called before.
+ * @warning
+ * @param[in] No input parameter
+ * @param[Out] No output parameter
+*/
+static void bench_irq_init(void)
+{
+	timer_set_callback(BENCH_IRQ_TIMER, bench_irq_cb, 0);
+	interrupt_enable(TIMER_IRQ(BENCH_IRQ_TIMER));
+}
+
+
+/** @fn bench_irq_arm
+ * @brief Make the timer interrupt pending with interrupts off.
+ * @details
+ * @warning
+ * @param[in] void *arg: not used.
+ * @param[Out] No output parameter
+*/
+static void bench_irq_arm(void *arg)
+{
+	clear_csr(mstatus, MSTATUS_MIE);
+	fired = 0;
+	timer_run_in_intr_mode(BENCH_IRQ_TIMER, BENCH_IRQ_CLOCKS);
+	while(!(read_csr(mip) & MIP_MEIP))
+		;
+}
+
+
+/** @fn bench_irq_take
+ * @brief Take the pending interrupt.
+ * @details The interrupt is taken as soon as MIE is set, so the run is the trap entry,
+ *	    the dispatch, the timer callback and the return to this function.
+ * @warning
+ * @param[in] void *arg: not used.
+ * @param[Out] No output parameter
+*/
+static void bench_irq_take(void *arg)
+{
+	set_csr(mstatus, MSTATUS_MIE);
+	while(!fired)
+		;
+}
+
+
+static const BENCH_CASE_type irq_cases[] =
+{
+	BENCH_CASE_SETUP("timer", bench_irq_arm, bench_irq_take, 0),
+	BENCH_END
+};
+
+BENCH_SUITE(irq, bench_irq_init);
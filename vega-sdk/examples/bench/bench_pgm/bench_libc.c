@@ -0,0 +1,106 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: bench_libc.c
+ Purpose		: Microbenchmark harness
+ Description		: printf, memcpy and memset suites
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "bench.h"
+
+void* memset(void* dest, int byte, size_t len);
+void* memcpy(void* dest, const void* src, size_t len);
+
+static UL src_buf[1024 / sizeof(UL) + 1], dst_buf[1024 / sizeof(UL) + 1];
+
+
+/** @fn bench_printf_empty
+ * @brief printf of an empty string.
+ * @details The formatting cost, nothing is sent.
+ * @warning
+ * @param[in] void *arg: not used.
+ * @param[Out] No output parameter
+*/
+static void bench_printf_empty(void *arg)
+{
+	printf("%s", "");
+}
+
+
+/** @fn bench_printf_int
+ * @brief printf of a line with a number.
+ * @details Formatting and sending 12 characters over the debug UART.
+ * @warning
+ * @param[in] void *arg: not used.
+ * @param[Out] No output parameter
+*/
+static void bench_printf_int(void *arg)
+{
+	printf("\n\r%u", 1234567890);
+}
+
+
+/** @fn bench_memcpy
+ * @brief Aligned memcpy.
+ * @details The length is the argument, so the compiler cannot expand the copy inline.
+ * @warning
+ * @param[in] void *arg: bytes.
+ * @param[Out] No output parameter
+*/
+static void bench_memcpy(void *arg)
+{
+	memcpy(dst_buf, src_buf, (size_t)arg);
+}
+
+
+/** @fn bench_memcpy_unaligned
+ * @brief memcpy from an odd address.
+ * @details
+ * @warning
+ * @param[in] void *arg: bytes.
+ * @param[Out] No output parameter
+*/
+static void bench_memcpy_unaligned(void *arg)
+{
+	memcpy(dst_buf, (UC *)src_buf + 1, (size_t)arg);
+}
+
+
+/** @fn bench_memset
+ * @brief Aligned memset.
+ * @details
+ * @warning
+ * @param[in] void *arg: bytes.
+ * @param[Out] No output parameter
+*/
+static void bench_memset(void *arg)
+{
+	memset(dst_buf, 0x5A, (size_t)arg);
+}
+
+
+static const BENCH_CASE_type printf_cases[] =
+{
+	BENCH_CASE("empty", bench_printf_empty, 0),
+	BENCH_CASE("int", bench_printf_int, 0),
+	BENCH_END
+};
+
+static const BENCH_CASE_type memcpy_cases[] =
+{
+	BENCH_CASE("memcpy_64", bench_memcpy, 64),
+	BENCH_CASE("memcpy_1024", bench_memcpy, 1024),
+	BENCH_CASE("memcpy_1024_unaligned", bench_memcpy_unaligned, 1024),
+	BENCH_CASE("memset_64", bench_memset, 64),
+	BENCH_CASE("memset_1024", bench_memset, 1024),
+	BENCH_END
+};
+
+BENCH_SUITE(printf, 0);
+BENCH_SUITE(memcpy, 0);
@@ -0,0 +1,56 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: main.c
+ Purpose		: Microbenchmark harness
+ Description		: Cycle and instruction counts of libvega paths as CSV
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "interrupt.h"
+#include "bench.h"
+
+BENCH_SUITE_DECLARE(printf);
+BENCH_SUITE_DECLARE(memcpy);
+BENCH_SUITE_DECLARE(uart);
+BENCH_SUITE_DECLARE(spi);
+BENCH_SUITE_DECLARE(i2c);
+BENCH_SUITE_DECLARE(irq);
+
+static const BENCH_SUITE_type *suites[] =
+{
+	&bench_suite_printf,
+	&bench_suite_memcpy,
+	&bench_suite_uart,
+	&bench_suite_spi,
+	&bench_suite_i2c,
+	&bench_suite_irq,
+};
+
+
+/** @fn main
+ * @brief Microbenchmark harness
+ * @details Runs every suite. Lines starting with "bench," are the CSV report, cycles are
+ *	    core clock cycles less the timing cost.
+ * @warning 
+ * @param[in] No input parameter 
+ * @param[Out] No output parameter 
+*/
+void main ()
+{
+	printf("\n\r INFO: libvega microbenchmarks, %d runs after %d warm-up runs", BENCH_RUNS, BENCH_WARMUP);
+
+	initialize_interrupt_table();
+	bench_init();
+
+	for(UI i = 0; i < sizeof(suites) / sizeof(suites[0]); i++)
+		bench_run(suites[i]);
+	printf("\n\r");
+
+	while(1);
+}
@@ -0,0 +1,49 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: main.c
+ Purpose		: Debounced inputs
+ Description		: Prints press, release and hold events of eight switches
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "gpio.h"
+#include "input.h"
+#include "timer.h"
+#include "interrupt.h"
+#include "timebase.h"
+
+#define INPUT_TICK_CLOCKS	200000	// 5 ms tick at 40 MHz, 20 ms debouncing.
+#define INPUT_HOLD_TICKS	200	// Hold event every second.
+
+/** @fn main
+ * @brief Debounced inputs
+ * @details Switches on GPIO 0 pins 0..7, pulled up and closing to ground.
+ * @warning
+ * @param[in] No input parameter
+ * @param[Out] No output parameter
+*/
+void main ()
+{
+	const char *name[] = { "press", "release", "hold" };
+	INPUT_EVENT_type ev;
+
+	printf("\n\r INFO: Connect switches to GPIO 0..7, active low\n\r");
+
+	initialize_interrupt_table();
+	input_init(INPUT_HOLD_TICKS);
+	for(US i = 0; i < 8; i++)
+		input_add(PIN_0 + i, INPUT_ACTIVE_LOW);
+	input_start(TIMER_0, INPUT_TICK_CLOCKS);
+
+	while(1)
+	{
+		if(input_get_event(&ev))
+			printf("\n\r pin %d %s at %u ms", ev.pin_no, name[ev.type], (UI)time_cycles_to_ms(ev.time));
+	}
+}
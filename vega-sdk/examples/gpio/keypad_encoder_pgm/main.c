@@ -0,0 +1,58 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: main.c
+ Purpose		: Keypad and encoders
+ Description		: 4x4 keypad and two quadrature encoders decoded in the background
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "gpio.h"
+#include "keypad.h"
+#include "encoder.h"
+#include "timer.h"
+#include "interrupt.h"
+
+#define KEYPAD_TICK_CLOCKS	80000	// 2 ms per row at 40 MHz.
+#define ENCODER_TICK_CLOCKS	2000	// 20 kHz sampling at 40 MHz.
+#define ENCODER_WINDOW		2000	// Velocity in counts per 100 ms.
+
+/** @fn main
+ * @brief Keypad and encoders
+ * @details Keypad rows on GPIO 0 pins 0..3, columns on pins 4..7 with pull-ups.
+ *	    Encoder 0 on pins 8 and 9, encoder 1 on pins 10 and 11.
+ * @warning
+ * @param[in] No input parameter
+ * @param[Out] No output parameter
+*/
+void main ()
+{
+	const US rows[KEYPAD_ROWS] = { PIN_0, PIN_1, PIN_2, PIN_3 };
+	const US cols[KEYPAD_COLS] = { PIN_4, PIN_5, PIN_6, PIN_7 };
+	const char keys[] = "123A456B789C*0#D";
+	UC key, pressed;
+
+	printf("\n\r INFO: Keypad on GPIO 0..7, encoders on GPIO 8..11\n\r");
+
+	initialize_interrupt_table();
+	keypad_init(rows, cols);
+	keypad_start(TIMER_0, KEYPAD_TICK_CLOCKS);
+
+	encoder_init(ENCODER_WINDOW);
+	encoder_add(PIN_8, PIN_9);
+	encoder_add(PIN_10, PIN_11);
+	encoder_start(TIMER_1, ENCODER_TICK_CLOCKS);
+
+	while(1)
+	{
+		if(keypad_get_event(&key, &pressed) && pressed)
+			printf("\n\r key %c  enc0 %d (%d/100ms)  enc1 %d (%d/100ms)", keys[key],
+			       encoder_count(0), encoder_velocity(0),
+			       encoder_count(1), encoder_velocity(1));
+	}
+}
@@ -0,0 +1,63 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: main.c
+ Purpose		: Multi sensor ultrasonic ranging
+ Description		: Eight HC-SR04 sensors ranged concurrently
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "gpio.h"
+#include "ranging.h"
+#include "timer.h"
+#include "interrupt.h"
+
+#define RANGING_TICK_CLOCKS	800	// 20 us tick at 40 MHz.
+#define RANGING_PERIOD		3000	// 60 ms schedule.
+#define RANGING_GROUPS		4	// Sensors fired together, facing away from each other.
+
+/** @fn main
+ * @brief Multi sensor ultrasonic ranging
+ * @details Triggers of sensor n on GPIO 0 pin n, echoes on GPIO 0 pin n+8.
+ *	    Two sensors are fired every 15 ms and every sensor is read every 60 ms.
+ * @warning
+ * @param[in] No input parameter
+ * @param[Out] No output parameter
+*/
+void main ()
+{
+	US distance[RANGING_MAX_SENSORS];
+	UI seq = 0, last_seq = 0;
+
+	printf("\n\r INFO: Connect eight HC-SR04 sensors, TRIG to GPIO 0..7, ECHO to GPIO 8..15\n\r");
+
+	initialize_interrupt_table();
+	ranging_init(RANGING_PERIOD);
+	for(US i = 0; i < 8; i++)
+		ranging_add(PIN_0 + i, PIN_8 + i, (i % RANGING_GROUPS) * (RANGING_PERIOD / RANGING_GROUPS));
+	ranging_start(TIMER_0, RANGING_TICK_CLOCKS);
+
+	while(1)
+	{
+		// The CPU is free here, the distances are updated in the background.
+		seq = ranging_read(7, &distance[7]);
+		if(seq == last_seq)
+			continue;
+		last_seq = seq;
+
+		for(UC i = 0; i < 8; i++)
+		{
+			ranging_read(i, &distance[i]);
+			if(distance[i] == RANGING_NO_ECHO)
+				printf("   --- ");
+			else
+				printf(" %4d mm", distance[i]);
+		}
+		printf("\r");
+	}
+}
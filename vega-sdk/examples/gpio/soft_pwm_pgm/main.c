@@ -0,0 +1,52 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: main.c
+ Purpose		: Software PWM
+ Description		: 16 channel software PWM on GPIO 0
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "gpio.h"
+#include "soft_pwm.h"
+#include "timer.h"
+#include "interrupt.h"
+
+#define PWM_PERIOD_CLOCKS	40000	// 1 kHz at 40 MHz.
+#define PWM_STEPS		100
+
+/** @fn main
+ * @brief 16 channel software PWM
+ * @details Channel n drives GPIO 0 pin n. The duties ramp with a phase offset per
+ *	    channel, so the edges are spread over the period.
+ * @warning
+ * @param[in] No input parameter
+ * @param[Out] No output parameter
+*/
+void main ()
+{
+	US duty = 0;
+
+	printf("\n\r INFO: 16 channel software PWM on GPIO 0 pins 0..15");
+
+	initialize_interrupt_table();
+	soft_pwm_init(PWM_PERIOD_CLOCKS, PWM_STEPS);
+	for(US i = 0; i < 16; i++)
+		soft_pwm_add(PIN_0 + i);
+	soft_pwm_start(TIMER_0);
+
+	while(1)
+	{
+		for(UC i = 0; i < 16; i++)
+			soft_pwm_set(i, (duty + i * 6) % (PWM_STEPS + 1), i * 6);
+		soft_pwm_update();
+		duty = (duty + 1) % (PWM_STEPS + 1);
+
+		udelay(20000);
+	}
+}
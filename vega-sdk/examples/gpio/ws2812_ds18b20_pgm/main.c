@@ -0,0 +1,83 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: main.c
+ Purpose		: WS2812 and DS18B20
+ Description		: Shows a DS18B20 temperature on a WS2812 strip
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "gpio.h"
+#include "ws2812.h"
+#include "onewire.h"
+#include "timer.h"
+#include "delay.h"
+
+#define STRIP_PIN		PIN_0
+#define SENSOR_PIN		PIN_1	// 4.7k pull-up to 3.3 V.
+#define LEDS			8
+
+#define DS18B20_CONVERT_T	0x44
+#define DS18B20_READ_SCRATCH	0xBE
+
+/** @fn main
+ * @brief WS2812 and DS18B20
+ * @details Lights one LED per 5 C, blue below 20 C and red above.
+ * @warning
+ * @param[in] No input parameter
+ * @param[Out] No output parameter
+*/
+void main ()
+{
+	UC grb[LEDS * 3];
+	UC scratch[9];
+	int temp;
+
+	printf("\n\r INFO: WS2812 strip on GPIO 0, DS18B20 on GPIO 1\n\r");
+
+	delay_init(TIMER_2);			// Measured clock for the WS2812 bit timing.
+	ws2812_init(STRIP_PIN);
+	onewire_init(SENSOR_PIN);
+
+	while(1)
+	{
+		if(!onewire_reset(SENSOR_PIN))
+		{
+			printf("\n\r No DS18B20 found");
+			continue;
+		}
+		onewire_write_byte(SENSOR_PIN, ONEWIRE_CMD_SKIP_ROM);
+		onewire_write_byte(SENSOR_PIN, DS18B20_CONVERT_T);
+		while(!onewire_read_bit(SENSOR_PIN))	// Conversion done.
+			;
+
+		onewire_reset(SENSOR_PIN);
+		onewire_write_byte(SENSOR_PIN, ONEWIRE_CMD_SKIP_ROM);
+		onewire_write_byte(SENSOR_PIN, DS18B20_READ_SCRATCH);
+		for(UC i = 0; i < 9; i++)
+			scratch[i] = onewire_read_byte(SENSOR_PIN);
+		if(onewire_crc8(scratch, 9) != 0)
+		{
+			printf("\n\r CRC error");
+			continue;
+		}
+
+		temp = (short)(scratch[0] | (scratch[1] << 8)) / 16;
+		printf("\n\r %d C", temp);
+
+		for(UC i = 0; i < LEDS; i++)
+		{
+			UC on = (temp > i * 5);
+
+			grb[i * 3 + 0] = 0;
+			grb[i * 3 + 1] = (on && temp >= 20) ? 64 : 0;
+			grb[i * 3 + 2] = (on && temp < 20) ? 64 : 0;
+		}
+		ws2812_write(STRIP_PIN, grb, LEDS);
+	}
+}
@@ -0,0 +1,83 @@
+/***************************************************
+
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: main.c
+ Purpose		: I2C sensor polling scheduler
+ Description		: Polls I2C sensors at different rates
+
+ See LICENSE for license details.
+ ***************************************************/
+
+/**
+ @file main.c
+ @brief I2C polling scheduler sample
+ @detail Reads an LM75 temperature sensor every 100 ms and the
+ accelerometer of an MPU6050 every 5 ms using the I2C scheduler.
+ */
+
+#include "stdlib.h"
+#include "config.h"
+#include "i2c.h"
+#include "i2c_sched.h"
+#include "timer.h"
+#include "interrupt.h"
+
+#define SCHED_TICK_CLOCKS	40000	// 1 ms tick at 40 MHz.
+
+/**
+ @fn main
+ @brief Polls two I2C sensors at different rates
+ @details The timer releases the transactions, the main loop runs them
+ and prints the latest temperature once per second.
+ @param[in] No input parameters.
+ @param[Out] No ouput parameter.
+ @return Void function.
+
+ */
+void main() {
+	I2C_SCHED_XFER xfer;
+	int lm75, mpu6050;
+	UC temp[2], accel[6];
+	UI last_seq = 0, seq;
+
+	printf("I2C sensor scheduler\n\r");
+
+	initialize_interrupt_table();
+	i2c_sched_init();
+
+	xfer.i2c_number = I2C_0;
+	xfer.slave_address = 0x48;		// LM75
+	xfer.reg[0] = 0x00;			// Temperature register
+	xfer.reg_length = 1;
+	xfer.read_length = 2;
+	xfer.period = 100;
+	xfer.phase = 0;
+	lm75 = i2c_sched_add(&xfer);
+
+	xfer.slave_address = 0x68;		// MPU6050
+	xfer.reg[0] = 0x3B;			// ACCEL_XOUT_H
+	xfer.read_length = 6;
+	xfer.period = 5;
+	xfer.phase = 1;				// Keep off the LM75 slot.
+	mpu6050 = i2c_sched_add(&xfer);
+
+	i2c_sched_start(TIMER_0, SCHED_TICK_CLOCKS);
+
+	while (1) {
+		i2c_sched_poll();
+
+		i2c_sched_read(mpu6050, accel);	// Latest accelerometer sample.
+
+		seq = i2c_sched_read(lm75, temp);
+		if (seq >= last_seq + 10) {
+			last_seq = seq;
+			printf("Temperature : %d C  accel x : %d  errors : %d\n\r",
+					(signed char) temp[0],
+					(short) ((accel[0] << 8) | accel[1]),
+					i2c_sched_errors(lm75) + i2c_sched_errors(mpu6050));
+		}
+	}
+}
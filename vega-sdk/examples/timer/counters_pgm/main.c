@@ -0,0 +1,66 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: main.c
+ Purpose		: Performance counters
+ Description		: Cycles, instructions and CPI of named code regions as CSV
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "counters.h"
+
+static volatile UI sink;
+
+
+/** @fn main
+ * @brief Performance counters
+ * @details Adds, divides and loads from a table, each in its own region. Lines starting
+ *	    with "counters," are the CSV report.
+ * @warning 
+ * @param[in] No input parameter 
+ * @param[Out] No output parameter 
+*/
+void main ()
+{
+	static UI table[256];
+	int add, div, load;
+	UI s;
+
+	counters_init();
+	add = counters_region("add");
+	div = counters_region("div");
+	load = counters_region("load");
+
+	for(UI run = 0; run < 10; run++)
+	{
+		counters_start(add);
+		s = 0;
+		for(UI i = 0; i < 1000; i++)
+			s += i;
+		sink = s;
+		counters_stop(add);
+
+		counters_start(div);
+		s = 0;
+		for(UI i = 1; i < 1000; i++)
+			s += 0xFFFFFFFF / i;
+		sink = s;
+		counters_stop(div);
+
+		counters_start(load);
+		s = 0;
+		for(UI i = 0; i < 1000; i++)
+			s += table[(i * 37) & 255];
+		sink = s;
+		counters_stop(load);
+	}
+
+	counters_report();
+
+	while(1);
+}
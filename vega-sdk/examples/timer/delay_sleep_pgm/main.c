@@ -0,0 +1,50 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: main.c
+ Purpose		: Calibrated delays
+ Description		: Calibrates the delays and checks their accuracy against the time base
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "delay.h"
+#include "timer.h"
+#include "interrupt.h"
+#include "timebase.h"
+
+/** @fn main
+ * @brief Calibrated delays
+ * @details Prints the measured core clock and the cycles taken by delays of several
+ *	    lengths, spinning (below DELAY_SLEEP_MIN_US) and sleeping in wfi.
+ * @warning
+ * @param[in] No input parameter
+ * @param[Out] No output parameter
+*/
+void main ()
+{
+	const UI us[] = { 1, 10, 100, 1000, 100000 };
+	ULL start, taken;
+
+	initialize_interrupt_table();
+	delay_init(TIMER_2);
+	printf("\n\r INFO: Core clock %u Hz (nominal %u Hz)", (UI)delay_core_hz(), (UI)CORE_CLOCK_HZ);
+
+	for(UC i = 0; i < sizeof(us) / sizeof(us[0]); i++)
+	{
+		start = time_now_cycles();
+		delay_us(us[i]);
+		taken = time_now_cycles() - start;
+		printf("\n\r delay_us(%u): %u cycles, expected %u", us[i], (UI)taken, (UI)time_us_to_cycles(us[i]));
+	}
+
+	while(1)
+	{
+		delay_ms(1000);
+		printf("\n\r tick");
+	}
+}
@@ -0,0 +1,119 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: main.c
+ Purpose		: Nested interrupts
+ Description		: Worst case latency of a high priority timer next to a slow low priority one
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "timer.h"
+#include "interrupt.h"
+#include "timebase.h"
+#include "delay.h"
+
+#define FAST_TIMER		TIMER_0
+#define FAST_PERIOD_CLOCKS	8000	// 200 us control tick at 40 MHz.
+#define SLOW_TIMER		TIMER_1
+#define SLOW_PERIOD_CLOCKS	40000	// 1 ms.
+#define SLOW_BUSY_US		100	// Stands for a slow I2C completion, below the fast period.
+#define RUN_TICKS		5000	// Fast ticks per run, one second.
+
+static volatile UI fast_ticks;
+static UI fast_lat_max;
+
+
+/** @fn fast_cb
+ * @brief High priority tick.
+ * @details The timer reloaded when it interrupted, LoadCount - CurrentValue is the latency
+ *	    in timer clocks as long as it is below the period.
+ * @warning 
+ * @param[in] void *ctx: not used.
+ * @param[Out] No output parameter 
+*/
+static void fast_cb(void *ctx)
+{
+	UI lat = Timer(FAST_TIMER).LoadCount - Timer(FAST_TIMER).CurrentValue;
+
+	if(lat > fast_lat_max)
+		fast_lat_max = lat;
+	fast_ticks++;
+}
+
+
+/** @fn slow_cb
+ * @brief Low priority handler.
+ * @details Busy for longer than the fast tick period.
+ * @warning 
+ * @param[in] void *ctx: not used.
+ * @param[Out] No output parameter 
+*/
+static void slow_cb(void *ctx)
+{
+	delay_cycles(TIME_US2CYC(SLOW_BUSY_US));
+}
+
+
+/** @fn run
+ * @brief Run both timers for RUN_TICKS fast ticks.
+ * @details
+ * @warning 
+ * @param[in] unsigned char nesting
+ * @param[Out] Worst case latency of the fast tick in timer clocks.
+*/
+static UI run(UC nesting)
+{
+	irq_nesting(nesting);
+	fast_ticks = 0;
+	fast_lat_max = 0;
+
+	timer_run_in_intr_mode(SLOW_TIMER, SLOW_PERIOD_CLOCKS);
+	timer_run_in_intr_mode(FAST_TIMER, FAST_PERIOD_CLOCKS);
+	interrupt_enable(TIMER_IRQ(SLOW_TIMER));
+	interrupt_enable(TIMER_IRQ(FAST_TIMER));
+
+	while(fast_ticks < RUN_TICKS)
+		;
+
+	interrupt_disable(TIMER_IRQ(FAST_TIMER));
+	interrupt_disable(TIMER_IRQ(SLOW_TIMER));
+	Timer(FAST_TIMER).Control = 0x0;
+	Timer(SLOW_TIMER).Control = 0x0;
+
+	return fast_lat_max;
+}
+
+
+/** @fn main
+ * @brief Nested interrupts
+ * @details Without nesting the fast tick waits for the slow handler, up to SLOW_BUSY_US.
+ *	    With nesting it preempts it and the worst case is the entry and dispatch time.
+ * @warning 
+ * @param[in] No input parameter 
+ * @param[Out] No output parameter 
+*/
+void main ()
+{
+	UI lat;
+
+	initialize_interrupt_table();
+
+	timer_set_callback(FAST_TIMER, fast_cb, 0);
+	timer_set_callback(SLOW_TIMER, slow_cb, 0);
+	irq_set_priority(TIMER_IRQ(FAST_TIMER), IRQ_PRIORITY_HIGHEST);
+	irq_set_priority(TIMER_IRQ(SLOW_TIMER), IRQ_PRIORITY_DEFAULT);
+
+	printf("\n\r INFO: fast tick every %d clocks, slow handler busy %d us", FAST_PERIOD_CLOCKS, SLOW_BUSY_US);
+
+	lat = run(0);
+	printf("\n\r nesting off: worst fast latency %u clocks, %u us", lat, (UI)(lat / (TIMER_CLOCK_HZ / 1000000)));
+	lat = run(1);
+	printf("\n\r nesting on:  worst fast latency %u clocks, %u us", lat, (UI)(lat / (TIMER_CLOCK_HZ / 1000000)));
+
+	while(1);
+}
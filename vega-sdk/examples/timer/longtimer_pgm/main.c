@@ -0,0 +1,69 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: main.c
+ Purpose		: Long period timer
+ Description		: Periodic timeout longer than one 32 bit timer count
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "timer.h"
+#include "interrupt.h"
+#include "longtimer.h"
+#include "timebase.h"
+#include "delay.h"
+
+#define LONG_PERIOD_S	300	// 5 minutes, 32 bit counts end after 107 s at 40 MHz.
+
+static volatile UI expiries;
+static volatile ULL expiry_time;
+
+
+/** @fn long_cb
+ * @brief Timeout callback.
+ * @details Time stamps the expiry on the time base.
+ * @warning 
+ * @param[in] void *ctx: not used.
+ * @param[Out] No output parameter 
+*/
+static void long_cb(void *ctx)
+{
+	expiry_time = time_now_cycles();
+	expiries++;
+}
+
+
+/** @fn main
+ * @brief Long period timer
+ * @details Prints the time left every 10 s and the time of every expiry.
+ * @warning 
+ * @param[in] No input parameter 
+ * @param[Out] No output parameter 
+*/
+void main ()
+{
+	UI seen = 0;
+	ULL start;
+
+	initialize_interrupt_table();
+
+	printf("\n\r INFO: Timeout every %d s", LONG_PERIOD_S);
+	start = time_now_cycles();
+	longtimer_start(TIMER_1, LONGTIMER_S(LONG_PERIOD_S), LONGTIMER_S(LONG_PERIOD_S), long_cb, 0);
+
+	while(1)
+	{
+		delay_ms(10000);
+		if(expiries != seen)
+		{
+			seen = expiries;
+			printf("\n\r expiry %u at %u ms", seen, (UI)time_cycles_to_ms(expiry_time - start));
+		}
+		printf("\n\r %u ms left", (UI)(longtimer_remaining(TIMER_1) / (TIMER_CLOCK_HZ / 1000)));
+	}
+}
@@ -0,0 +1,83 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: main.c
+ Purpose		: PC sampling profiler
+ Description		: Profiles two workloads and sends the histogram for tools/vega_prof.py
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "timer.h"
+#include "interrupt.h"
+#include "profiler.h"
+
+#define PROFILE_CLOCKS	4000	// 10 kHz sampling at 40 MHz.
+#define PROFILE_SAMPLES	20000
+
+static volatile UI sink;
+
+
+/** @fn work_sum
+ * @brief Light workload.
+ * @details
+ * @warning 
+ * @param[in] unsigned int n
+ * @param[Out] No output parameter 
+*/
+static void __attribute__((noinline)) work_sum(UI n)
+{
+	UI s = 0;
+
+	for(UI i = 0; i < n; i++)
+		s += i;
+	sink = s;
+}
+
+
+/** @fn work_div
+ * @brief Heavy workload, divisions.
+ * @details Should take about four times the samples of work_sum.
+ * @warning 
+ * @param[in] unsigned int n
+ * @param[Out] No output parameter 
+*/
+static void __attribute__((noinline)) work_div(UI n)
+{
+	UI s = 0;
+
+	for(UI i = 1; i < n; i++)
+		s += 0xFFFFFFFF / i;
+	sink = s;
+}
+
+
+/** @fn main
+ * @brief PC sampling profiler
+ * @details Capture the UART output to a file and run
+ *	    tools/vega_prof.py build/profiler_pgm.elf capture.bin
+ * @warning 
+ * @param[in] No input parameter 
+ * @param[Out] No output parameter 
+*/
+void main ()
+{
+	initialize_interrupt_table();
+
+	profiler_reset();
+	profiler_start(TIMER_0, PROFILE_CLOCKS);
+	while(profiler_samples() < PROFILE_SAMPLES)
+	{
+		work_sum(1000);
+		work_div(1000);
+	}
+	profiler_stop();
+
+	profiler_dump();
+
+	while(1);
+}
@@ -0,0 +1,88 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: main.c
+ Purpose		: Software timers
+ Description		: Hundreds of software timers on one hardware timer
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "gpio.h"
+#include "swtimer.h"
+#include "timer.h"
+#include "interrupt.h"
+
+#define TIMERS		200
+
+static SWTIMER_type blink[4];
+static SWTIMER_type load[TIMERS];
+static SWTIMER_type report;
+static volatile UI expired;
+static US leds;
+
+/** @fn blink_cb
+ * @brief Toggle an LED, runs in the timer interrupt.
+*/
+static void blink_cb(void *ctx)
+{
+	US pin = (US)(UL)ctx;
+
+	leds ^= GPIO_PIN_MASK(pin);
+	GPIO_write_port(GPIO_0, GPIO_PIN_MASK(pin), leds);
+}
+
+/** @fn load_cb
+ * @brief One shot timer, restarted with a new timeout from its own callback.
+*/
+static void load_cb(void *ctx)
+{
+	UI i = (UI)(UL)ctx;
+
+	expired++;
+	swtimer_start(&load[i], SWTIMER_MS(10 + (i * 37) % 1000), 0);
+}
+
+/** @fn report_cb
+ * @brief Deferred callback, prints from the main loop.
+*/
+static void report_cb(void *ctx)
+{
+	printf("\n\r %u ms: %u timeouts", (UI)(swtimer_now() * SWTIMER_TICK_US / 1000), expired);
+}
+
+/** @fn main
+ * @brief Software timers
+ * @details LEDs on GPIO 0 pins 0..3 blink at different rates, 200 timeouts with
+ *	    random lengths are restarted as they expire and a report is printed
+ *	    every second, all from TIMER_0.
+ * @warning
+ * @param[in] No input parameter
+ * @param[Out] No output parameter
+*/
+void main ()
+{
+	initialize_interrupt_table();
+	swtimer_init(TIMER_0);
+
+	for(UI i = 0; i < 4; i++)
+	{
+		GPIO_config_pin(PIN_0 + i, GPIO_DIR_OUT);
+		swtimer_setup(&blink[i], blink_cb, (void *)(UL)(PIN_0 + i), 0);
+		swtimer_start(&blink[i], SWTIMER_MS(100), SWTIMER_MS(100 * (i + 1)));
+	}
+	for(UI i = 0; i < TIMERS; i++)
+	{
+		swtimer_setup(&load[i], load_cb, (void *)(UL)i, 0);
+		swtimer_start(&load[i], SWTIMER_MS(i + 1), 0);
+	}
+	swtimer_setup(&report, report_cb, 0, SWTIMER_DEFERRED);
+	swtimer_start(&report, SWTIMER_MS(1000), SWTIMER_MS(1000));
+
+	while(1)
+		swtimer_run_deferred();
+}
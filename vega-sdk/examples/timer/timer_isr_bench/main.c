@@ -0,0 +1,148 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: main.c
+ Purpose		: Timer ISR benchmark
+ Description		: Measures the latency and the duration of the timer interrupt callbacks
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "timer.h"
+#include "interrupt.h"
+#include "timebase.h"
+#include "irq_stats.h"
+
+#define BENCH_TIMER		TIMER_0
+#define BENCH_PERIOD_CLOCKS	4000	// 100 us at 40 MHz.
+#define BENCH_SAMPLES		10000
+#define BENCH_LOOP_SAMPLES	10000
+
+static volatile UI isr_count;
+static UI lat_min, lat_max;
+static ULL lat_sum;
+
+
+/** @fn bench_cb
+ * @brief Timer callback.
+ * @details The timer reloaded when it interrupted, so LoadCount - CurrentValue is the
+ *	    number of timer clocks from the interrupt to the callback.
+ * @warning 
+ * @param[in] void *ctx: not used.
+ * @param[Out] No output parameter 
+*/
+static void bench_cb(void *ctx)
+{
+	UI lat = Timer(BENCH_TIMER).LoadCount - Timer(BENCH_TIMER).CurrentValue;
+
+	if(lat < lat_min)
+		lat_min = lat;
+	if(lat > lat_max)
+		lat_max = lat;
+	lat_sum += lat;
+	isr_count++;
+}
+
+
+/** @fn bench_clocks_to_cycles
+ * @brief Timer clocks to core cycles.
+ * @details
+ * @warning 
+ * @param[in] unsigned int clocks
+ * @param[Out] Core cycles.
+*/
+static UI bench_clocks_to_cycles(UI clocks)
+{
+	return (UI)((ULL)clocks * time_scale.core_hz / TIMER_CLOCK_HZ);
+}
+
+
+/** @fn bench_run
+ * @brief Measure the interrupts of the bench timer.
+ * @details The foreground spins on the cycle counter, every gap longer than twice the loop
+ *	    time is one interrupt, from the trap entry through the BSP handler and the
+ *	    callback back to the loop. Runs for BENCH_SAMPLES gaps.
+ * @warning 
+ * @param[in] timer_callback fn: callback to measure, 0 for the bare handler.
+ *	      unsigned int loop_max: loop time in cycles.
+ * @param[Out] No output parameter 
+*/
+static void bench_run(timer_callback fn, UI loop_max)
+{
+	UI prev, now, gap;
+	UI gaps = 0, gap_min = 0xFFFFFFFF, gap_max = 0;
+	ULL gap_sum = 0;
+
+	timer_set_callback(BENCH_TIMER, fn, 0);
+	timer_run_in_intr_mode(BENCH_TIMER, BENCH_PERIOD_CLOCKS);
+	interrupt_enable(TIMER_IRQ(BENCH_TIMER));
+
+	prev = time_now_cycles32();
+	while(gaps < BENCH_SAMPLES)
+	{
+		now = time_now_cycles32();
+		gap = now - prev;
+		prev = now;
+		if(gap <= 2 * loop_max)
+			continue;
+		gap -= loop_max;
+		if(gap < gap_min)
+			gap_min = gap;
+		if(gap > gap_max)
+			gap_max = gap;
+		gap_sum += gap;
+		gaps++;
+	}
+
+	interrupt_disable(TIMER_IRQ(BENCH_TIMER));
+	Timer(BENCH_TIMER).Control = 0x0;
+
+	printf("\n\r duration: min %u avg %u max %u cycles", gap_min, (UI)(gap_sum / gaps), gap_max);
+}
+
+
+/** @fn main
+ * @brief Timer ISR benchmark
+ * @details Measures the loop time with interrupts off, then the interrupt duration with
+ *	    only the BSP handler, which is the trap entry and exit cost, and with the
+ *	    latency measuring callback.
+ * @warning 
+ * @param[in] No input parameter 
+ * @param[Out] No output parameter 
+*/
+void main ()
+{
+	UI prev, now, gap, loop_max = 0;
+
+	printf("\n\r INFO: Timer ISR benchmark, %d interrupts every %d timer clocks", BENCH_SAMPLES, BENCH_PERIOD_CLOCKS);
+
+	initialize_interrupt_table();
+
+	prev = time_now_cycles32();
+	for(UI i = 0; i < BENCH_LOOP_SAMPLES; i++)
+	{
+		now = time_now_cycles32();
+		gap = now - prev;
+		prev = now;
+		if(gap > loop_max)
+			loop_max = gap;
+	}
+	printf("\n\r loop: %u cycles max", loop_max);
+
+	printf("\n\r BSP handler only:");
+	bench_run(0, loop_max);
+
+	printf("\n\r latency callback:");
+	lat_min = 0xFFFFFFFF;
+	bench_run(bench_cb, loop_max);
+	printf("\n\r latency: min %u avg %u max %u cycles", bench_clocks_to_cycles(lat_min),
+		bench_clocks_to_cycles((UI)(lat_sum / isr_count)), bench_clocks_to_cycles(lat_max));
+
+	irq_stats_dump();					// Built with VEGA_IRQ_STATS=1 only.
+
+	while(1);
+}
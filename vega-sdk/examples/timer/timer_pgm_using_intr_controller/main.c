@@ -26,8 +26,24 @@
 #include "config.h"
 #include "timer.h"
 #include "interrupt.h"
+#include "delay.h"
 
 
+static volatile UI timer_count[3];
+
+
+/** @fn timer_count_cb
+ * @brief Timer callback.
+ * @details Counts the interrupts of one timer, printing is left to main.
+ * @warning 
+ * @param[in] void *ctx: counter of the timer.
+ * @param[Out] No output parameter 
+*/
+static void timer_count_cb(void *ctx)
+{
+	(*(volatile UI *)ctx)++;
+}
+
 
 /** @fn main
  * @brief Generate a delay in polling mode.
@@ -44,15 +60,23 @@ void main ()
 
 	printf("\n\r TIMER TEST CASE - INTR Method");
 
+	timer_set_callback(TIMER_0, timer_count_cb, (void *)&timer_count[0]);
+	timer_set_callback(TIMER_1, timer_count_cb, (void *)&timer_count[1]);
+	timer_set_callback(TIMER_2, timer_count_cb, (void *)&timer_count[2]);
+
 	timer_run_in_intr_mode(TIMER_0,0x200);
 	timer_run_in_intr_mode(TIMER_1,0x350);
 	timer_run_in_intr_mode(TIMER_2,0x500);
 
-	interrupt_enable(7); // For TIMER 0
-	interrupt_enable(8); // For TIMER 1
-	interrupt_enable(9); // For TIMER 2
+	interrupt_enable(TIMER_IRQ(TIMER_0));
+	interrupt_enable(TIMER_IRQ(TIMER_1));
+	interrupt_enable(TIMER_IRQ(TIMER_2));
 	
-	while(1);
+	while(1)
+	{
+		delay_ms(1000);
+		printf("\n\r TIMER intr count: %u %u %u", timer_count[0], timer_count[1], timer_count[2]);
+	}
 	
 }
 
@@ -0,0 +1,79 @@
+/*****************************************************************************
+
+ Project Name		: MDP - Microprocessor Development Project
+ Project Code		: HD083D
+ Created		: 19-Oct-2026
+ Filename		: main.c
+ Purpose		: Deferred interrupt work
+ Description		: Timer interrupt posts port samples, the main loop prints them
+
+ See LICENSE for license details.
+******************************************************************************/
+
+#include "stdlib.h"
+#include "config.h"
+#include "gpio.h"
+#include "timer.h"
+#include "interrupt.h"
+#include "timebase.h"
+#include "workq.h"
+
+#define SAMPLE_CLOCKS	4000000		// 100 ms at 40 MHz.
+
+typedef struct
+{
+	UI time_ms;
+	US port;
+}SAMPLE_type;
+
+
+/** @fn sample_print
+ * @brief Deferred part of the sampling.
+ * @details Runs from the main loop with interrupts enabled, so it may print.
+ * @warning 
+ * @param[in] void *ctx: not used. const unsigned char *data, unsigned char len: the sample.
+ * @param[Out] No output parameter 
+*/
+static void sample_print(void *ctx, const UC *data, UC len)
+{
+	const SAMPLE_type *s = (const SAMPLE_type *)data;
+
+	printf("\n\r %u ms: GPIO 0 = 0x%x", s->time_ms, s->port);
+}
+
+
+/** @fn sample_cb
+ * @brief Timer callback.
+ * @details Takes the sample and leaves the printing to the main loop.
+ * @warning 
+ * @param[in] void *ctx: not used.
+ * @param[Out] No output parameter 
+*/
+static void sample_cb(void *ctx)
+{
+	SAMPLE_type s;
+
+	s.time_ms = (UI)time_cycles_to_ms(time_now_cycles());
+	s.port = GPIO_read_port(GPIO_0, 0xFFFF);
+	workq_post(WORKQ_PRIORITY_CURRENT, sample_print, 0, &s, sizeof(s));
+}
+
+
+/** @fn main
+ * @brief Deferred interrupt work
+ * @details The main loop sleeps in workq_idle until work is posted.
+ * @warning 
+ * @param[in] No input parameter 
+ * @param[Out] No output parameter 
+*/
+void main ()
+{
+	initialize_interrupt_table();
+
+	timer_set_callback(TIMER_0, sample_cb, 0);
+	timer_run_in_intr_mode(TIMER_0, SAMPLE_CLOCKS);
+	interrupt_enable(TIMER_IRQ(TIMER_0));
+
+	while(1)
+		workq_idle();
+}
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+#
+# Project Name	: MDP - Microprocessor Development Project
+# Project Code	: HD083D
+# Created	: 19-Oct-2026
+# Filename	: vega_prof.py
+# Purpose	: Profiler report
+# Description	: Maps the histogram sent by profiler_dump() to functions
+#
+# See LICENSE for license details.
+#
+# usage: vega_prof.py program.elf|program.map dump.bin|/dev/ttyUSB0 [--baud 115200]
+#
+# The dump is read from a file, or from a serial port with pyserial. The
+# symbols come from the ELF through nm, or from the .map file written by
+# config.mk. A bucket is charged to the function its first address is in.
+
+import argparse
+import bisect
+import re
+import struct
+import subprocess
+import sys
+
+MAGIC = b"VPRF"
+END = 0xFFFF
+
+
+def read_dump(path, baud):
+	if path.startswith("/dev/") or path.upper().startswith("COM"):
+		import serial
+		port = serial.Serial(path, baud, timeout=10)
+		read = port.read
+	else:
+		f = open(path, "rb")
+		read = f.read
+
+	window = b""
+	while window != MAGIC:
+		c = read(1)
+		if not c:
+			sys.exit("no profiler dump found")
+		window = (window + c)[-4:]
+
+	def get(fmt):
+		size = struct.calcsize(fmt)
+		data = read(size)
+		if len(data) != size:
+			sys.exit("dump truncated")
+		return struct.unpack(fmt, data)
+
+	base, shift, _, buckets, samples, outside = get("<IBBHII")
+	counts = {}
+	while True:
+		(index,) = get("<H")
+		if index == END:
+			break
+		(counts[index],) = get("<I")
+	return base, shift, samples, outside, counts
+
+
+def symbols_from_elf(elf, nm):
+	out = subprocess.run([nm, "-n", "--defined-only", elf], capture_output=True, text=True, check=True).stdout
+	syms = []
+	for line in out.splitlines():
+		parts = line.split()
+		if len(parts) == 3 and parts[1] in "TtWw":
+			syms.append((int(parts[0], 16), parts[2]))
+	return syms
+
+
+def symbols_from_map(path):
+	syms = []
+	in_text = False
+	for line in open(path):
+		if re.match(r"^\s*\.(text|INTERRUPT)", line):
+			in_text = True
+		elif re.match(r"^\s*\.\w", line) and not line.startswith("  .text"):
+			in_text = False
+		m = re.match(r"^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_]\w*)\s*$", line)
+		if in_text and m:
+			syms.append((int(m.group(1), 16), m.group(2)))
+	return sorted(syms)
+
+
+def main():
+	ap = argparse.ArgumentParser(description="VEGA PC sampling profiler report")
+	ap.add_argument("program", help="ELF or .map file of the profiled program")
+	ap.add_argument("dump", help="dump file or serial port")
+	ap.add_argument("--baud", type=int, default=115200)
+	ap.add_argument("--nm", default="riscv64-vega-elf-nm")
+	ap.add_argument("--top", type=int, default=30)
+	args = ap.parse_args()
+
+	base, shift, samples, outside, counts = read_dump(args.dump, args.baud)
+	if args.program.endswith(".map"):
+		syms = symbols_from_map(args.program)
+	else:
+		syms = symbols_from_elf(args.program, args.nm)
+	addrs = [a for a, _ in syms]
+
+	per_func = {}
+	for index, count in counts.items():
+		addr = base + (index << shift)
+		i = bisect.bisect_right(addrs, addr) - 1
+		name = syms[i][1] if i >= 0 else "0x%x" % addr
+		per_func[name] = per_func.get(name, 0) + count
+
+	total = max(samples, 1)
+	print("%d samples, %d outside the image, %d byte buckets" % (samples, outside, 1 << shift))
+	print("%7s %9s  %s" % ("%", "samples", "function"))
+	for name, count in sorted(per_func.items(), key=lambda x: -x[1])[:args.top]:
+		print("%6.2f%% %9d  %s" % (100.0 * count / total, count, name))
+
+
+if __name__ == "__main__":
+	main()